@@ -0,0 +1,124 @@
+#include "aggregated_fuzzy_set.hh"
+
+#include <stdexcept>
+#include <algorithm>
+
+AggregatedFuzzySet::AggregatedFuzzySet(
+	DomainInterface* d,
+	const CompiledRuleBase* r,
+	CompiledRuleBase::Implication i,
+	const double* s,
+	int output
+): domain{d}, rules{r}, implication{i}, strengths{s} {
+	if (domain == nullptr) {
+		throw std::invalid_argument("the domain must not be null");
+	}
+	if (rules == nullptr) {
+		throw std::invalid_argument("the rules must not be null");
+	}
+	if (strengths == nullptr) {
+		throw std::invalid_argument("the strengths must not be null");
+	}
+	if (domain->getCardinality() != rules->getOutputCardinality()) {
+		throw std::invalid_argument("the domain must match the rules' output universe");
+	}
+	if (output < 0 || output >= rules->getNumberOfOutputs()) {
+		throw std::out_of_range("the output must be one of the rules' outputs");
+	}
+
+	first_consequent = rules->getFirstConsequent(output);
+	consequents = rules->getFirstConsequent(output + 1) - first_consequent;
+}
+
+DomainInterface* AggregatedFuzzySet::getDomain() {
+	return domain;
+}
+
+double AggregatedFuzzySet::getValueAt(const DomainElement& e) const {
+	const int index{domain->indexOfElement(e)};
+	if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
+		throw std::domain_error("the element must be inside of the set's core domain");
+	}
+
+	return getValueAtIndex(index);
+}
+
+double AggregatedFuzzySet::getValueAtIndex(int index) const {
+	double max{0.0};
+	for (int c{first_consequent}; c < first_consequent + consequents; ++c) {
+		const double strength{strengths[c]};
+		if (strength == 0.0) {
+			continue;
+		}
+
+		const double consequent{rules->consequentValueAt(c, index)};
+		if (implication == CompiledRuleBase::Implication::PRODUCT) {
+			max = std::max(max, strength * consequent);
+		} else {
+			max = std::max(max, std::min(strength, consequent));
+		}
+	}
+
+	return max;
+}
+
+void AggregatedFuzzySet::copyMemberships(std::span<double> out) const {
+	const int card{rules->getOutputCardinality()};
+	if (out.size() != static_cast<std::size_t>(card)) {
+		throw std::invalid_argument("the output must have the domain's cardinality");
+	}
+
+	std::fill(out.begin(), out.end(), 0.0);
+	for (int c{first_consequent}; c < first_consequent + consequents; ++c) {
+		const double strength{strengths[c]};
+		if (strength == 0.0) {
+			continue;
+		}
+
+		if (implication == CompiledRuleBase::Implication::PRODUCT) {
+			for (int i{0}; i < card; ++i) {
+				out[i] = std::max(out[i], strength * rules->consequentValueAt(c, i));
+			}
+		} else {
+			for (int i{0}; i < card; ++i) {
+				out[i] = std::max(out[i], std::min(strength, rules->consequentValueAt(c, i)));
+			}
+		}
+	}
+}
+
+CompiledRuleBase::Implication AggregatedFuzzySet::getImplication() const {
+	return implication;
+}
+
+int AggregatedFuzzySet::getFirst() const {
+	return rules->getFirst();
+}
+
+int AggregatedFuzzySet::getLast() const {
+	return rules->getLast();
+}
+
+int AggregatedFuzzySet::getNumberOfConsequents() const {
+	return consequents;
+}
+
+double AggregatedFuzzySet::getStrength(int consequent) const {
+	return strengths[first_consequent + consequent];
+}
+
+const std::vector<Trapezoid>& AggregatedFuzzySet::getTrapezoids(int consequent) const {
+	return rules->getConsequentTrapezoids(first_consequent + consequent);
+}
+
+double AggregatedFuzzySet::getCentroid(int consequent) const {
+	return rules->getConsequentCentroid(first_consequent + consequent);
+}
+
+double AggregatedFuzzySet::getPeak(int consequent) const {
+	return rules->getConsequentPeak(first_consequent + consequent);
+}
+
+double AggregatedFuzzySet::getHeight(int consequent) const {
+	return rules->getConsequentHeight(first_consequent + consequent);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "fuzzy_set_interface.hh"
+#include "domain_interface.hh"
+#include "domain_element.hh"
+#include "compiled_rule_base.hh"
+#include "trapezoid.hh"
+
+#include <vector>
+
+/**
+ * The output of a rule base: the union of its consequents, each one scaled or
+ * clipped by its firing strength. The strengths are stored elsewhere, as written
+ * by the rule base, and only the consequents of the given output are used.
+ */
+class AggregatedFuzzySet : public FuzzySetInterface {
+public:
+	AggregatedFuzzySet(
+		DomainInterface* d,
+		const CompiledRuleBase* rules,
+		CompiledRuleBase::Implication implication,
+		const double* strengths,
+		int output = 0
+	);
+
+	DomainInterface* getDomain() override;
+	double           getValueAt(const DomainElement&) const override;
+	double           getValueAtIndex(int index) const override;
+	void             copyMemberships(std::span<double> out) const override;
+
+	CompiledRuleBase::Implication getImplication() const;
+	int                           getFirst() const;
+	int                           getLast() const;
+	int                           getNumberOfConsequents() const;
+	double                        getStrength(int consequent) const;
+	const std::vector<Trapezoid>& getTrapezoids(int consequent) const;
+	double                        getCentroid(int consequent) const;
+	double                        getPeak(int consequent) const;
+	double                        getHeight(int consequent) const;
+private:
+	DomainInterface*              domain;
+	const CompiledRuleBase*       rules;
+	CompiledRuleBase::Implication implication;
+	const double*                 strengths;
+	int                           first_consequent;
+	int                           consequents;
+};
@@ -0,0 +1,54 @@
+#include "alloc_counter.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> allocations{0};
+static thread_local std::size_t thread_allocations{0};
+
+std::size_t AllocCounter::getAllocations() {
+	return allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t AllocCounter::getThreadAllocations() {
+	return thread_allocations;
+}
+
+void* operator new(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	++thread_allocations;
+
+	// Like the default operator new, the new handler gets to free memory before it fails
+	void* p{std::malloc(size == 0 ? 1 : size)};
+	while (p == nullptr) {
+		const std::new_handler handler{std::get_new_handler()};
+		if (handler == nullptr) {
+			throw std::bad_alloc();
+		}
+
+		handler();
+		p = std::malloc(size == 0 ? 1 : size);
+	}
+	return p;
+}
+
+void* operator new[](std::size_t size) {
+	return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+	std::free(p);
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts the heap allocations made through the global operator new, which it replaces,
+// so it's only linked into the benchmarks
+namespace AllocCounter {
+	std::size_t getAllocations();
+	// The allocations made by the calling thread
+	std::size_t getThreadAllocations();
+};
@@ -0,0 +1,96 @@
+#include "alpha_cut_index.hh"
+
+#include "floating_point.hh"
+
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+
+AlphaCutIndex::AlphaCutIndex(std::span<const double> memberships):
+	order(memberships.size()), sorted(memberships.size()), sums(memberships.size() + 1) {
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [memberships](int a, int b) {
+		return memberships[a] > memberships[b];
+	});
+
+	sums[0] = 0.0;
+	for (std::size_t k{0}; k < order.size(); ++k) {
+		sorted[k] = memberships[order[k]];
+		sums[k + 1] = sums[k] + sorted[k];
+	}
+}
+
+int AlphaCutIndex::cutSize(double alpha) const {
+	// The memberships are descending, the cut ends at the first one below alpha
+	return std::partition_point(sorted.begin(), sorted.end(), [alpha](double m) {
+		return m >= alpha;
+	}) - sorted.begin();
+}
+
+std::span<const int> AlphaCutIndex::cut(double alpha) const {
+	return std::span<const int>(order).first(cutSize(alpha));
+}
+
+std::span<const int> AlphaCutIndex::strongCut(double alpha) const {
+	const int size(std::partition_point(sorted.begin(), sorted.end(), [alpha](double m) {
+		return m > alpha;
+	}) - sorted.begin());
+
+	return std::span<const int>(order).first(size);
+}
+
+std::span<const int> AlphaCutIndex::support() const {
+	return strongCut(0.0);
+}
+
+std::span<const int> AlphaCutIndex::core() const {
+	const int size(std::partition_point(sorted.begin(), sorted.end(), [](double m) {
+		return m >= 1.0 || FloatingPoint::isEqual(m, 1.0);
+	}) - sorted.begin());
+
+	return std::span<const int>(order).first(size);
+}
+
+double AlphaCutIndex::height() const {
+	return sorted.empty() ? 0.0 : std::max(sorted.front(), 0.0);
+}
+
+double AlphaCutIndex::sigmaCount() const {
+	return sums.back();
+}
+
+double AlphaCutIndex::sigmaCount(double alpha) const {
+	return sums[cutSize(alpha)];
+}
+
+void AlphaCutIndex::cutSizes(std::span<const double> alphas, std::span<int> out) const {
+	if (out.size() != alphas.size()) {
+		throw std::invalid_argument("the output must have a size for every level");
+	}
+
+	for (std::size_t i{0}; i < alphas.size(); ++i) {
+		out[i] = cutSize(alphas[i]);
+	}
+}
+
+void AlphaCutIndex::sigmaCounts(std::span<const double> alphas, std::span<double> out) const {
+	if (out.size() != alphas.size()) {
+		throw std::invalid_argument("the output must have a sigma-count for every level");
+	}
+
+	for (std::size_t i{0}; i < alphas.size(); ++i) {
+		out[i] = sums[cutSize(alphas[i])];
+	}
+}
+
+MembershipWriter::MembershipWriter(std::span<double> m, std::optional<AlphaCutIndex>& i): memberships{m}, index{i} {
+	index.reset();
+}
+
+MembershipWriter::~MembershipWriter() {
+	index.reset();
+}
+
+std::span<double> MembershipWriter::getMemberships() const {
+	return memberships;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <optional>
+
+/**
+ * The indices of a set's elements sorted by their memberships, from the highest
+ * down, with the running sums of the memberships. Every alpha-cut is a prefix of
+ * the order, so the cuts and their sigma-counts are found by a binary search.
+ */
+class AlphaCutIndex {
+public:
+	explicit AlphaCutIndex(std::span<const double> memberships);
+
+	// The elements with a membership of at least alpha, from the highest membership down
+	std::span<const int> cut(double alpha) const;
+	// The elements with a membership above alpha
+	std::span<const int> strongCut(double alpha) const;
+	std::span<const int> support() const;
+	// The elements with a membership equal to 1, within FloatingPoint::isEqual
+	std::span<const int> core() const;
+
+	double height() const;
+	// The sum of the memberships of all of the elements, or of the ones in the alpha-cut
+	double sigmaCount() const;
+	double sigmaCount(double alpha) const;
+
+	// The cardinalities and the sigma-counts of the alpha-cuts of every level
+	void cutSizes(std::span<const double> alphas, std::span<int> out) const;
+	void sigmaCounts(std::span<const double> alphas, std::span<double> out) const;
+private:
+	int cutSize(double alpha) const;
+
+	std::vector<int>    order;
+	std::vector<double> sorted;
+	// The sum of the first k sorted memberships is at k
+	std::vector<double> sums;
+};
+
+/**
+ * Writes the memberships of a set in place, e.g. MutableFuzzySet::write. The
+ * set's alpha-cut index is dropped when the writer is made and again when it
+ * goes out of scope, so the queries after the writes see them.
+ */
+class MembershipWriter {
+public:
+	MembershipWriter(std::span<double> memberships, std::optional<AlphaCutIndex>& index);
+	~MembershipWriter();
+
+	MembershipWriter(const MembershipWriter&) = delete;
+	MembershipWriter& operator=(const MembershipWriter&) = delete;
+
+	// Only valid while the writer is
+	std::span<double> getMemberships() const;
+private:
+	std::span<double>             memberships;
+	std::optional<AlphaCutIndex>& index;
+};
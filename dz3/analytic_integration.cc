@@ -0,0 +1,172 @@
+#include "analytic_integration.hh"
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+// The piece over an interval between two knots, where it is linear: its right limit
+// at x0 and its left limit at x1, so that a vertical edge at a knot doesn't count
+static std::pair<double, double> pieceOn(
+	const AnalyticIntegration::Piece& p,
+	CompiledRuleBase::Implication implication,
+	double x0,
+	double x1
+) {
+	const RealTrapezoid& t{p.t};
+	const double m{(x0 + x1) / 2.0};
+	if (m <= t.a || m >= t.d) {
+		return {0.0, 0.0};
+	}
+
+	double r0{1.0};
+	double r1{1.0};
+	if (m < t.b) {
+		r0 = (x0 - t.a) / (t.b - t.a);
+		r1 = (x1 - t.a) / (t.b - t.a);
+	} else if (m > t.c) {
+		r0 = 1.0 - (x0 - t.c) / (t.d - t.c);
+		r1 = 1.0 - (x1 - t.c) / (t.d - t.c);
+	}
+
+	if (implication == CompiledRuleBase::Implication::PRODUCT) {
+		return {p.strength * r0, p.strength * r1};
+	}
+	// The clipping points are knots, so the piece is clipped over the whole interval or nowhere
+	if (t.valueAt(m) >= p.strength) {
+		return {p.strength, p.strength};
+	}
+	return {r0, r1};
+}
+
+AnalyticIntegration::Moments AnalyticIntegration::integrate(
+	std::span<const Piece> pieces,
+	CompiledRuleBase::Implication implication,
+	double lo,
+	double hi
+) {
+	// Scratch space is reused between the calls, so the steady state doesn't allocate
+	thread_local std::vector<double> knots;
+	thread_local std::vector<std::size_t> order;
+	thread_local std::vector<std::size_t> active;
+	// A line over an interval, by its value at the start and its change to the end
+	thread_local std::vector<std::pair<double, double>> lines;
+	knots.clear();
+
+	const auto addKnot{[&](double x) {
+		if (x > lo && x < hi) {
+			knots.push_back(x);
+		}
+	}};
+
+	for (const Piece& p : pieces) {
+		const RealTrapezoid& t{p.t};
+		if (t.b != RealTrapezoid::OPEN_LEFT) {
+			addKnot(t.a);
+			addKnot(t.b);
+			if (implication == CompiledRuleBase::Implication::MIN) {
+				addKnot(t.a + p.strength * (t.b - t.a));
+			}
+		}
+		if (t.c != RealTrapezoid::OPEN_RIGHT) {
+			addKnot(t.c);
+			addKnot(t.d);
+			if (implication == CompiledRuleBase::Implication::MIN) {
+				addKnot(t.c + (1.0 - p.strength) * (t.d - t.c));
+			}
+		}
+	}
+
+	knots.push_back(lo);
+	knots.push_back(hi);
+	std::sort(knots.begin(), knots.end());
+	knots.erase(std::unique(knots.begin(), knots.end()), knots.end());
+
+	// The pieces that aren't zero everywhere, by the start of their supports
+	order.clear();
+	for (std::size_t i{0}; i < pieces.size(); ++i) {
+		if (pieces[i].strength > 0.0) {
+			order.push_back(i);
+		}
+	}
+	std::sort(order.begin(), order.end(), [pieces](std::size_t i, std::size_t j) {
+		return pieces[i].t.a < pieces[j].t.a;
+	});
+
+	Moments moments{0, 0};
+	const auto addSegment{[&moments](double u0, double u1, double f0, double f1) {
+		moments.area += (u1 - u0) * (f0 + f1) / 2.0;
+		moments.moment += (u1 - u0) * (f0 * (2.0 * u0 + u1) + f1 * (u0 + 2.0 * u1)) / 6.0;
+	}};
+
+	// Sweeps the knots with the pieces whose supports overlap the current interval
+	active.clear();
+	std::size_t next{0};
+	for (std::size_t k{0}; k + 1 < knots.size(); ++k) {
+		const double x0{knots[k]};
+		const double x1{knots[k + 1]};
+
+		// A start within (lo, hi) is a knot, so a piece starts at or before the interval's start
+		for (; next < order.size() && pieces[order[next]].t.a <= x0; ++next) {
+			active.push_back(order[next]);
+		}
+		std::erase_if(active, [&pieces, x0](std::size_t i) {
+			return pieces[i].t.d <= x0;
+		});
+		if (active.empty()) {
+			continue;
+		}
+
+		// Every piece is a line over the interval, from v0 at x0 to v0 + slope at x1
+		lines.clear();
+		for (const std::size_t i : active) {
+			const auto [v0, v1]{pieceOn(pieces[i], implication, x0, x1)};
+			lines.push_back({v0, v1 - v0});
+		}
+
+		// The envelope starts on the highest line, the steepest one of a tie, and only
+		// changes to the line that overtakes the current one first
+		std::size_t current{0};
+		for (std::size_t j{1}; j < lines.size(); ++j) {
+			if (
+				lines[j].first > lines[current].first
+				|| (lines[j].first == lines[current].first && lines[j].second > lines[current].second)
+			) {
+				current = j;
+			}
+		}
+
+		double t{0.0};
+		while (true) {
+			const auto [v, slope]{lines[current]};
+
+			double until{1.0};
+			std::size_t overtaking{current};
+			for (std::size_t j{0}; j < lines.size(); ++j) {
+				if (lines[j].second <= slope) {
+					continue;
+				}
+
+				const double crossing{(v - lines[j].first) / (lines[j].second - slope)};
+				if (crossing > t && (crossing < until || (crossing == until && lines[j].second > lines[overtaking].second))) {
+					until = crossing;
+					overtaking = j;
+				}
+			}
+
+			addSegment(
+				x0 + t * (x1 - x0),
+				x0 + until * (x1 - x0),
+				std::max(v + slope * t, 0.0),
+				std::max(v + slope * until, 0.0)
+			);
+			if (overtaking == current) {
+				break;
+			}
+
+			t = until;
+			current = overtaking;
+		}
+	}
+
+	return moments;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "trapezoid.hh"
+#include "compiled_rule_base.hh"
+
+#include <span>
+
+/**
+ * Integrates the union (max) of trapezoids scaled or clipped by their firing
+ * strengths in closed form. Every trapezoid is linear between its breakpoints,
+ * so the envelope is integrated exactly over the pieces between the breakpoints
+ * and the points where two trapezoids cross. The breakpoints are swept once,
+ * with the trapezoids whose supports overlap the current interval, and within
+ * an interval only the line overtaking the highest one is intersected with it.
+ * The cost depends on the number of trapezoids only, not on the resolution of
+ * the universe.
+ */
+namespace AnalyticIntegration {
+	struct Piece {
+		RealTrapezoid t;
+		double        strength;
+	};
+
+	// The integrals of the envelope f and of x * f
+	struct Moments {
+		double area;
+		double moment;
+	};
+
+	Moments integrate(
+		std::span<const Piece> pieces,
+		CompiledRuleBase::Implication implication,
+		double lo,
+		double hi
+	);
+}
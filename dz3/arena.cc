@@ -0,0 +1,120 @@
+#include "arena.hh"
+
+#include <algorithm>
+
+Arena::Arena(): generation{std::make_shared<std::uint64_t>(0)}, resource{std::make_unique<Resource>(this)} {
+}
+
+Arena::~Arena() {
+	destroy();
+}
+
+Arena::Arena(Arena&& other) noexcept:
+	blocks{std::move(other.blocks)},
+	current{other.current},
+	offset{other.offset},
+	used{other.used},
+	destructors{other.destructors},
+	generation{std::move(other.generation)},
+	resource{std::move(other.resource)} {
+	// The handles and the containers follow the objects, the moved from arena starts over
+	resource->arena = this;
+	other.blocks.clear();
+	other.current = 0;
+	other.offset = 0;
+	other.used = 0;
+	other.destructors = nullptr;
+	other.generation = std::make_shared<std::uint64_t>(0);
+	other.resource = std::make_unique<Resource>(&other);
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+	if (this != &other) {
+		destroy();
+
+		blocks = std::move(other.blocks);
+		current = other.current;
+		offset = other.offset;
+		used = other.used;
+		destructors = other.destructors;
+		generation = std::move(other.generation);
+		resource = std::move(other.resource);
+		resource->arena = this;
+
+		other.blocks.clear();
+		other.current = 0;
+		other.offset = 0;
+		other.used = 0;
+		other.destructors = nullptr;
+		other.generation = std::make_shared<std::uint64_t>(0);
+		other.resource = std::make_unique<Resource>(&other);
+	}
+
+	return *this;
+}
+
+void Arena::destroy() {
+	// The newest objects go first, they may refer to the older ones
+	for (Destructor* d{destructors}; d != nullptr; d = d->next) {
+		d->destroy(d->object);
+	}
+	destructors = nullptr;
+
+	if (generation != nullptr) {
+		++*generation;
+	}
+}
+
+void Arena::reset() {
+	destroy();
+
+	current = 0;
+	offset = 0;
+	used = 0;
+}
+
+void* Arena::allocate(std::size_t size, std::size_t alignment) {
+	while (current < blocks.size()) {
+		Block& block{blocks[current]};
+		const std::uintptr_t address{reinterpret_cast<std::uintptr_t>(block.memory.get()) + offset};
+		const std::size_t padding{(alignment - address % alignment) % alignment};
+
+		if (offset + padding + size <= block.size) {
+			offset += padding + size;
+			used += size;
+			return block.memory.get() + offset - size;
+		}
+
+		// The rest of a block is left unused rather than searched later
+		++current;
+		offset = 0;
+	}
+
+	// A block holds at least the object, the allocations are aligned to the block's memory
+	const std::size_t block_size{std::max(BLOCK_SIZE, size + alignment)};
+	blocks.push_back({std::make_unique<std::byte[]>(block_size), block_size});
+	current = blocks.size() - 1;
+	offset = 0;
+
+	return allocate(size, alignment);
+}
+
+std::pmr::memory_resource* Arena::getResource() {
+	return resource.get();
+}
+
+void* Arena::Resource::do_allocate(std::size_t bytes, std::size_t alignment) {
+	return arena->allocate(bytes, alignment);
+}
+
+std::size_t Arena::getUsed() const {
+	return used;
+}
+
+std::size_t Arena::getCapacity() const {
+	std::size_t capacity{0};
+	for (const Block& block : blocks) {
+		capacity += block.size;
+	}
+	return capacity;
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <new>
+#include <utility>
+#include <concepts>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * A checked reference to an object owned by an Arena. It doesn't own the
+ * object, but it knows the reset of the arena it was made in, so using it after
+ * the arena is reset or destroyed throws instead of touching freed memory.
+ */
+template<typename T>
+class Handle {
+public:
+	Handle(T* o, std::shared_ptr<const std::uint64_t> g):
+		object{o}, arena_generation{std::move(g)}, generation{*arena_generation} {
+	}
+
+	// A handle to a derived object is a handle to its base, e.g. Handle<DomainInterface>
+	template<typename U>
+	requires std::convertible_to<U*, T*>
+	Handle(const Handle<U>& other):
+		object{other.object}, arena_generation{other.arena_generation}, generation{other.generation} {
+	}
+
+	bool isValid() const {
+		return *arena_generation == generation;
+	}
+
+	T* get() const {
+		if (!isValid()) {
+			throw std::logic_error("the handle outlived the objects of its arena");
+		}
+		return object;
+	}
+
+	T* operator->() const {
+		return get();
+	}
+
+	T& operator*() const {
+		return *get();
+	}
+private:
+	template<typename U>
+	friend class Handle;
+
+	T*                                   object;
+	std::shared_ptr<const std::uint64_t> arena_generation;
+	std::uint64_t                        generation;
+};
+
+/**
+ * Owns the objects built for one computation, e.g. the sets of one tick or the
+ * terms of one rule base. Objects are bump allocated from blocks which are kept
+ * between the resets, so the steady state doesn't allocate. A reset rewinds to
+ * the first block in O(1), it only has to destroy the objects that aren't
+ * trivially destructible, e.g. the sets which own their memberships. Their
+ * memberships are allocated from the arena too, through getResource.
+ */
+class Arena {
+public:
+	static constexpr std::size_t BLOCK_SIZE{1 << 16};
+
+	Arena();
+	~Arena();
+
+	Arena(Arena&& other) noexcept;
+	Arena& operator=(Arena&& other) noexcept;
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	template<typename T, typename... Args>
+	Handle<T> make(Args&&... args) {
+		T* object{new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...)};
+
+		if constexpr (!std::is_trivially_destructible_v<T>) {
+			Destructor* d{new (allocate(sizeof(Destructor), alignof(Destructor))) Destructor{
+				[](void* o) { static_cast<T*>(o)->~T(); },
+				object,
+				destructors
+			}};
+			destructors = d;
+		}
+
+		return {object, generation};
+	}
+
+	// Destroys the objects and invalidates their handles, the blocks are reused
+	void reset();
+
+	// Allocates from the arena, deallocating does nothing until the reset
+	std::pmr::memory_resource* getResource();
+
+	// The bytes handed out since the last reset, and the bytes of the blocks
+	std::size_t getUsed() const;
+	std::size_t getCapacity() const;
+private:
+	struct Destructor {
+		void (*destroy)(void*);
+		void*       object;
+		Destructor* next;
+	};
+
+	struct Block {
+		std::unique_ptr<std::byte[]> memory;
+		std::size_t                  size;
+	};
+
+	// Stays at its address when the arena moves, the containers using it keep a pointer
+	class Resource : public std::pmr::memory_resource {
+	public:
+		explicit Resource(Arena* a): arena{a} {
+		}
+
+		Arena* arena;
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+		void  do_deallocate(void*, std::size_t, std::size_t) override {
+		}
+		bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	};
+
+	void* allocate(std::size_t size, std::size_t alignment);
+	void  destroy();
+
+	std::vector<Block>             blocks;
+	// The block being filled and the offset of its first free byte
+	std::size_t                    current{0};
+	std::size_t                    offset{0};
+	std::size_t                    used{0};
+	Destructor*                    destructors{nullptr};
+	std::shared_ptr<std::uint64_t> generation;
+	std::unique_ptr<Resource>      resource;
+};
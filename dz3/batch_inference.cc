@@ -0,0 +1,62 @@
+#include "batch_inference.hh"
+
+#include "aggregated_fuzzy_set.hh"
+#include "thread_pool.hh"
+
+#include <stdexcept>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+void BatchInference::infer(
+	const CompiledRuleBase& rules,
+	CompiledRuleBase::Implication implication,
+	const Defuzzifier* df,
+	DomainInterface* domain,
+	const FuzzySystem::Columns& inputs,
+	std::span<int> out
+) {
+	const std::size_t n{inputs.size()};
+	if (out.size() < n) {
+		throw std::invalid_argument("the output must be at least as large as the input");
+	}
+
+	const int blocks{static_cast<int>((n + CompiledRuleBase::BATCH_SIZE - 1) / CompiledRuleBase::BATCH_SIZE)};
+	const int consequents{rules.getNumberOfConsequents()};
+
+	const auto inferBlocks{[&](int begin, int end) {
+		// Strengths of the block by consequent, and then of a single tuple
+		std::vector<double> block_strengths(consequents * CompiledRuleBase::BATCH_SIZE);
+		std::vector<double> strengths(consequents);
+
+		for (int block{begin}; block < end; ++block) {
+			const std::size_t first{static_cast<std::size_t>(block) * CompiledRuleBase::BATCH_SIZE};
+			const int size{static_cast<int>(std::min<std::size_t>(CompiledRuleBase::BATCH_SIZE, n - first))};
+
+			const std::array<const int*, CompiledRuleBase::INPUTS> columns{
+				inputs.left.data() + first,
+				inputs.right.data() + first,
+				inputs.left_angled.data() + first,
+				inputs.right_angled.data() + first,
+				inputs.speed.data() + first,
+				inputs.direction.data() + first
+			};
+			rules.fireBatch(columns, size, implication, block_strengths.data());
+
+			for (int j{0}; j < size; ++j) {
+				for (int c{0}; c < consequents; ++c) {
+					strengths[c] = block_strengths[c * size + j];
+				}
+
+				AggregatedFuzzySet result(domain, &rules, implication, strengths.data());
+				out[first + j] = df->defuzzy(&result);
+			}
+		}
+	}};
+
+	if (blocks > 1) {
+		ThreadPool::getDefault().parallelFor(blocks, inferBlocks);
+	} else {
+		inferBlocks(0, blocks);
+	}
+}
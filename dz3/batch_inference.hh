@@ -0,0 +1,24 @@
+#pragma once
+
+#include "fuzzy_system.hh"
+#include "compiled_rule_base.hh"
+#include "defuzzifier.hh"
+#include "domain_interface.hh"
+
+#include <span>
+
+namespace BatchInference {
+	/**
+	 * Fires the rules for blocks of tuples at once and defuzzifies every tuple.
+	 * Batches of more than one block are split between the default thread pool.
+	 * The results are the same as those of infer of the fuzzy systems.
+	 */
+	void infer(
+		const CompiledRuleBase& rules,
+		CompiledRuleBase::Implication implication,
+		const Defuzzifier* df,
+		DomainInterface* domain,
+		const FuzzySystem::Columns& inputs,
+		std::span<int> out
+	);
+}
@@ -0,0 +1,230 @@
+#include "compiled_rule_base.hh"
+#include "defuzzifier.hh"
+#include "defuzzifier_coa.hh"
+#include "defuzzifier_analytic_coa.hh"
+#include "defuzzifier_mom.hh"
+#include "defuzzifier_bisector.hh"
+#include "defuzzifier_height.hh"
+#include "defuzzifier_sugeno.hh"
+#include "multi_output_fuzzy_system.hh"
+#include "continuous_fuzzy_system.hh"
+#include "rules.hh"
+#include "fast_io.hh"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using Inputs = std::array<int, CompiledRuleBase::INPUTS>;
+
+// The ticks in the format the simulator sends, one tuple of inputs per line
+static std::vector<Inputs> readInputs(const char* path) {
+	const int fd{open(path, O_RDONLY)};
+	if (fd < 0) {
+		throw std::invalid_argument("can't open the recorded inputs " + std::string(path));
+	}
+
+	std::vector<Inputs> inputs;
+	FastReader reader(fd);
+	Inputs in;
+	while (reader.nextInts(in)) {
+		inputs.push_back(in);
+	}
+	close(fd);
+
+	return inputs;
+}
+
+// Random inputs within the ranges, when no recording is given
+static std::vector<Inputs> randomInputs(int n) {
+	std::mt19937 generator(42);
+	std::vector<Inputs> inputs(n);
+	const auto ranges{Rules::get_input_ranges()};
+	for (Inputs& in : inputs) {
+		for (int i{0}; i < CompiledRuleBase::INPUTS; ++i) {
+			in[i] = std::uniform_int_distribution<int>(ranges[i].first, ranges[i].last)(generator);
+		}
+	}
+
+	return inputs;
+}
+
+// The center of area of the rules' output sampled densely over [first, last], with the terms extended to the reals
+static double sampledCenterOfArea(
+	const std::vector<std::array<IntUnaryFunction const*, 7>>& rules,
+	CompiledRuleBase::Implication implication,
+	const Inputs& in,
+	double first,
+	double last
+) {
+	const auto valueAt{[](IntUnaryFunction const* f, double x) {
+		double max{0.0};
+		for (const Trapezoid& t : f->getTrapezoids()) {
+			max = std::max(max, RealTrapezoid::fromTrapezoid(t).valueAt(x));
+		}
+		return max;
+	}};
+
+	std::vector<std::pair<IntUnaryFunction const*, double>> fired;
+	for (const auto& rule : rules) {
+		double strength{1.0};
+		for (int i{0}; i < CompiledRuleBase::INPUTS; ++i) {
+			const double val{valueAt(rule[i], in[i])};
+			strength = implication == CompiledRuleBase::Implication::PRODUCT ? strength * val : std::min(strength, val);
+		}
+		if (strength > 0.0) {
+			fired.emplace_back(rule[CompiledRuleBase::INPUTS], strength);
+		}
+	}
+
+	constexpr int SAMPLES{1 << 16};
+	const double step{(last - first) / SAMPLES};
+	double area{0.0};
+	double moment{0.0};
+	for (int k{0}; k < SAMPLES; ++k) {
+		const double x{first + (k + 0.5) * step};
+		double val{0.0};
+		for (const auto& [consequent, strength] : fired) {
+			const double c{valueAt(consequent, x)};
+			val = std::max(val, implication == CompiledRuleBase::Implication::PRODUCT ? strength * c : std::min(strength, c));
+		}
+		area += val * step;
+		moment += val * x * step;
+	}
+
+	return area == 0.0 ? 0.0 : moment / area;
+}
+
+/**
+ * Infers accel and omega of every tick with every defuzzifier and reports the
+ * time per tick and how far the outputs are from the sampled center of area,
+ * then the same for the center of area over the continuous universe. The
+ * continuous center of area is checked against a dense sampling of the output
+ * set for the first ticks, and a mismatch exits with 1.
+ * Usage: bench_defuzzifier [FILE], where FILE holds the recorded inputs.
+ */
+int main(int argc, char* argv[]) {
+	const std::vector<Inputs> inputs{argc > 1 ? readInputs(argv[1]) : randomInputs(20000)};
+	if (inputs.empty()) {
+		throw std::invalid_argument("there are no inputs to replay");
+	}
+
+	const std::vector<std::pair<std::string, Defuzzifier*>> defuzzifiers{
+		{"coa", new DefuzzifierCOA()},
+		{"analytic coa", new DefuzzifierAnalyticCOA()},
+		{"mean of maxima", new DefuzzifierMOM()},
+		{"bisector", new DefuzzifierBisector()},
+		{"height", new DefuzzifierHeight()},
+		{"sugeno", new DefuzzifierSugeno()}
+	};
+
+	std::vector<std::array<int, 2>> reference;
+	for (const auto& [name, df] : defuzzifiers) {
+		const MultiOutputFuzzySystem fs(
+			df,
+			{Rules::get_for_accel(), Rules::get_for_omega()},
+			CompiledRuleBase::Implication::PRODUCT,
+			Rules::get_input_ranges()
+		);
+
+		std::vector<std::array<int, 2>> outputs(inputs.size());
+		const auto start{std::chrono::steady_clock::now()};
+		for (std::size_t i{0}; i < inputs.size(); ++i) {
+			const Inputs& in{inputs[i]};
+			fs.infer(in[0], in[1], in[2], in[3], in[4], in[5], outputs[i]);
+		}
+		const auto end{std::chrono::steady_clock::now()};
+
+		if (reference.empty()) {
+			reference = outputs;
+		}
+
+		std::array<double, 2> error{0, 0};
+		std::array<int, 2> max_error{0, 0};
+		for (std::size_t i{0}; i < inputs.size(); ++i) {
+			for (int o{0}; o < 2; ++o) {
+				const int e{std::abs(outputs[i][o] - reference[i][o])};
+				error[o] += e;
+				max_error[o] = std::max(max_error[o], e);
+			}
+		}
+
+		std::cout << name << ": "
+			<< std::chrono::duration<double, std::nano>(end - start).count() / inputs.size() << " ns per tick, "
+			<< "accel error " << error[0] / inputs.size() << " mean " << max_error[0] << " max, "
+			<< "omega error " << error[1] / inputs.size() << " mean " << max_error[1] << " max" << std::endl;
+	}
+
+	const ContinuousFuzzySystem continuous(
+		{Rules::get_for_accel(), Rules::get_for_omega()},
+		CompiledRuleBase::Implication::PRODUCT,
+		-400,
+		399
+	);
+
+	std::vector<std::array<double, 2>> outputs(inputs.size());
+	const auto start{std::chrono::steady_clock::now()};
+	for (std::size_t i{0}; i < inputs.size(); ++i) {
+		const Inputs& in{inputs[i]};
+		continuous.infer(in[0], in[1], in[2], in[3], in[4], in[5], outputs[i]);
+	}
+	const auto end{std::chrono::steady_clock::now()};
+
+	std::array<double, 2> error{0, 0};
+	std::array<double, 2> max_error{0, 0};
+	for (std::size_t i{0}; i < inputs.size(); ++i) {
+		for (int o{0}; o < 2; ++o) {
+			const double e{std::abs(outputs[i][o] - reference[i][o])};
+			error[o] += e;
+			max_error[o] = std::max(max_error[o], e);
+		}
+	}
+
+	std::cout << "continuous: "
+		<< std::chrono::duration<double, std::nano>(end - start).count() / inputs.size() << " ns per tick, "
+		<< "accel error " << error[0] / inputs.size() << " mean " << max_error[0] << " max, "
+		<< "omega error " << error[1] / inputs.size() << " mean " << max_error[1] << " max" << std::endl;
+
+	int failures{0};
+	for (const CompiledRuleBase::Implication implication : {
+		CompiledRuleBase::Implication::PRODUCT,
+		CompiledRuleBase::Implication::MIN
+	}) {
+		const ContinuousFuzzySystem fs(
+			{Rules::get_for_accel(), Rules::get_for_omega()},
+			implication,
+			-400,
+			399
+		);
+
+		for (std::size_t i{0}; i < std::min<std::size_t>(inputs.size(), 50); ++i) {
+			const Inputs& in{inputs[i]};
+			std::array<double, 2> analytic;
+			fs.infer(in[0], in[1], in[2], in[3], in[4], in[5], analytic);
+
+			const std::array<double, 2> sampled{
+				sampledCenterOfArea(Rules::get_for_accel(), implication, in, -400, 399),
+				sampledCenterOfArea(Rules::get_for_omega(), implication, in, -400, 399)
+			};
+			for (int o{0}; o < 2; ++o) {
+				if (std::abs(analytic[o] - sampled[o]) > 1e-3) {
+					std::cerr << "the continuous center of area of the tick " << i << " is " << analytic[o]
+						<< ", sampled " << sampled[o] << std::endl;
+					++failures;
+				}
+			}
+		}
+	}
+
+	return failures == 0 ? 0 : 1;
+}
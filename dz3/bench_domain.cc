@@ -0,0 +1,421 @@
+#include "domain_builder.hh"
+#include "domain_interface.hh"
+#include "mutable_fuzzy_set.hh"
+#include "sparse_fuzzy_set.hh"
+#include "operations.hh"
+#include "relations.hh"
+#include "alloc_counter.hh"
+#include "arena.hh"
+#include "lazy_fuzzy_set.hh"
+#include "domain_iterator.hh"
+#include "floating_point.hh"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// The checks that failed, the benchmark exits with 1 if there are any
+static int failures{0};
+
+static void fail(const std::string& message) {
+	std::cerr << message << std::endl;
+	++failures;
+}
+
+static void check(bool ok, const std::string& message) {
+	if (!ok) {
+		fail(message);
+	}
+}
+
+// Whether the property reported by the analysis is the one of the predicate, or throws when it wasn't checked
+static bool agrees(const Relations::Analysis& analysis, bool (Relations::Analysis::*property)() const, bool expected) {
+	try {
+		return (analysis.*property)() == expected;
+	} catch (const std::logic_error&) {
+		return !analysis.complete;
+	}
+}
+
+// Compares both analyses of the relation with the predicates, and the early one with the full one
+static void checkAnalysis(FuzzySetInterface* relation, const std::string& name) {
+	const bool reflexive{Relations::isReflexive(relation)};
+	const bool symmetric{Relations::isSymmetric(relation)};
+	const bool transitive{Relations::isMaxMinTransitive(relation)};
+
+	const Relations::Analysis full{Relations::analyze(relation, false)};
+	check(full.complete, name + ": the full analysis isn't complete");
+	check(full.isReflexive() == reflexive, name + ": the analysis disagrees with isReflexive");
+	check(full.isSymmetric() == symmetric, name + ": the analysis disagrees with isSymmetric");
+	check(full.isMaxMinTransitive() == transitive, name + ": the analysis disagrees with isMaxMinTransitive");
+	check(
+		full.isFuzzyEquivalence() == Relations::isFuzzyEquivalence(relation),
+		name + ": the analysis disagrees with isFuzzyEquivalence"
+	);
+
+	const Relations::Analysis early{Relations::analyze(relation, true)};
+	check(
+		early.complete == (reflexive && symmetric && transitive),
+		name + ": the early analysis is complete only without violations"
+	);
+	check(agrees(early, &Relations::Analysis::isReflexive, reflexive), name + ": the early analysis misreports reflexivity");
+	check(agrees(early, &Relations::Analysis::isSymmetric, symmetric), name + ": the early analysis misreports symmetry");
+	check(
+		agrees(early, &Relations::Analysis::isMaxMinTransitive, transitive),
+		name + ": the early analysis misreports transitivity"
+	);
+	check(
+		agrees(early, &Relations::Analysis::isFuzzyEquivalence, reflexive && symmetric && transitive),
+		name + ": the early analysis misreports the equivalence"
+	);
+
+	// The violation an early analysis stops at is the first one of its property
+	for (const auto member : {&Relations::Analysis::reflexivity, &Relations::Analysis::symmetry, &Relations::Analysis::transitivity}) {
+		const std::optional<Relations::Violation>& e{early.*member};
+		const std::optional<Relations::Violation>& f{full.*member};
+		if (e.has_value()) {
+			check(
+				f.has_value() && e->x == f->x && e->y == f->y && e->z == f->z,
+				name + ": the early analysis stopped at another violation than the full one"
+			);
+		}
+	}
+}
+
+// The values of the element at the axes
+static DomainElement componentsAt(std::span<const int> values, std::span<const int> axes) {
+	std::vector<int> picked;
+	for (const int axis : axes) {
+		picked.push_back(values[axis]);
+	}
+	return DomainElement(picked.data(), picked.size());
+}
+
+// Projects a ternary relation onto every subset of its components and extends the projections back
+static void checkProjections(std::mt19937& generator) {
+	DomainInterface* a{DomainBuilder::intRange(-1, 2)};
+	DomainInterface* b{DomainBuilder::intRange(10, 14)};
+	DomainInterface* c{DomainBuilder::intRange(0, 2)};
+	DomainInterface* abc{DomainBuilder::combine({a, b, c})};
+
+	MutableFuzzySet relation(abc);
+	for (int i{0}; i < abc->getCardinality(); ++i) {
+		relation.setAtIndex(i, (generator() % 11) / 10.0);
+	}
+
+	const std::vector<std::vector<int>> subsets{{0}, {1}, {2}, {0, 1}, {0, 2}, {1, 2}, {0, 1, 2}};
+	for (const std::vector<int>& axes : subsets) {
+		std::string name{"the axes"};
+		for (const int axis : axes) {
+			name += ' ';
+			name += std::to_string(axis);
+		}
+
+		DomainInterface* onto{DomainBuilder::project(abc, axes)};
+		FuzzySetInterface* projected{Relations::projection(&relation, onto, axes)};
+
+		// The projection is the maximum over the other components
+		std::vector<double> expected(onto->getCardinality(), 0.0);
+		for (DomainIterator it(abc); !it.isDone(); it.next()) {
+			double& e{expected[onto->indexOfElement(componentsAt(it.getValues(), axes))]};
+			e = std::max(e, relation.getValueAtIndex(it.getIndex()));
+		}
+		for (int i{0}; i < onto->getCardinality(); ++i) {
+			check(projected->getValueAtIndex(i) == expected[i], "the projection onto " + name + " differs at " + std::to_string(i));
+		}
+
+		// The extension repeats the set along the other components, so it contains the relation
+		// and projecting it back gives the set
+		FuzzySetInterface* extended{Relations::cylindricalExtension(projected, abc, axes)};
+		for (DomainIterator it(abc); !it.isDone(); it.next()) {
+			const double e{extended->getValueAtIndex(it.getIndex())};
+			check(
+				e == projected->getValueAt(componentsAt(it.getValues(), axes)),
+				"the extension from " + name + " differs at " + std::to_string(it.getIndex())
+			);
+			check(
+				e >= relation.getValueAtIndex(it.getIndex()),
+				"the extension from " + name + " doesn't contain the relation at " + std::to_string(it.getIndex())
+			);
+		}
+
+		FuzzySetInterface* round_trip{Relations::projection(extended, onto, axes)};
+		for (int i{0}; i < onto->getCardinality(); ++i) {
+			check(
+				round_trip->getValueAtIndex(i) == projected->getValueAtIndex(i),
+				"projecting the extension from " + name + " back differs at " + std::to_string(i)
+			);
+		}
+	}
+}
+
+// The elements whose memberships satisfy the predicate, in the order of their indices
+template<typename Predicate>
+static std::vector<int> scan(std::span<const double> memberships, Predicate predicate) {
+	std::vector<int> elements;
+	for (std::size_t i{0}; i < memberships.size(); ++i) {
+		if (predicate(memberships[i])) {
+			elements.push_back(i);
+		}
+	}
+	return elements;
+}
+
+static bool sameElements(std::span<const int> cut, std::vector<int> expected) {
+	std::vector<int> sorted(cut.begin(), cut.end());
+	std::sort(sorted.begin(), sorted.end());
+	return sorted == expected;
+}
+
+// Compares the alpha-cut index of sets with many ties with linear scans, also after the sets change
+static void checkAlphaCuts(std::mt19937& generator) {
+	DomainInterface* u{DomainBuilder::intRange(0, 200)};
+	const double levels[]{0.0, 0.1, 0.3, 0.5, 0.5, 1.0};
+	const std::vector<double> alphas{0.0, 0.05, 0.1, 0.3, 0.4, 0.5, 0.99, 1.0};
+
+	for (int run{0}; run < 20; ++run) {
+		MutableFuzzySet set(u);
+		{
+			const MembershipWriter writer{set.write()};
+			for (double& m : writer.getMemberships()) {
+				m = levels[generator() % 6];
+			}
+		}
+		// The index is built before the last change, which must drop it
+		set.getAlphaCuts();
+		set.setAtIndex(generator() % 200, levels[generator() % 6]);
+
+		const AlphaCutIndex& index{set.getAlphaCuts()};
+		const std::span<const double> memberships{set.getMemberships()};
+		const std::string name{"the alpha-cuts of the set " + std::to_string(run)};
+
+		double height{0.0};
+		double sigma{0.0};
+		for (const double m : memberships) {
+			height = std::max(height, m);
+			sigma += m;
+		}
+		check(index.height() == height, name + " have another height");
+		check(std::abs(index.sigmaCount() - sigma) < 1e-9, name + " have another sigma-count");
+		check(sameElements(index.support(), scan(memberships, [](double m) { return m > 0.0; })), name + " have another support");
+		check(
+			sameElements(index.core(), scan(memberships, [](double m) { return m >= 1.0 || FloatingPoint::isEqual(m, 1.0); })),
+			name + " have another core"
+		);
+
+		std::vector<int> sizes(alphas.size());
+		std::vector<double> sigmas(alphas.size());
+		index.cutSizes(alphas, sizes);
+		index.sigmaCounts(alphas, sigmas);
+		for (std::size_t k{0}; k < alphas.size(); ++k) {
+			const double alpha{alphas[k]};
+			const std::string level{name + " at " + std::to_string(alpha)};
+
+			const std::vector<int> cut{scan(memberships, [alpha](double m) { return m >= alpha; })};
+			double cut_sigma{0.0};
+			for (const int i : cut) {
+				cut_sigma += memberships[i];
+			}
+
+			check(sameElements(index.cut(alpha), cut), level + " have another cut");
+			check(sameElements(index.strongCut(alpha), scan(memberships, [alpha](double m) { return m > alpha; })), level + " have another strong cut");
+			check(sizes[k] == static_cast<int>(cut.size()), level + " have another cut size");
+			check(std::abs(index.sigmaCount(alpha) - cut_sigma) < 1e-9, level + " have another sigma-count");
+			check(std::abs(sigmas[k] - cut_sigma) < 1e-9, level + " have another sigma-count of the levels");
+		}
+	}
+}
+
+static void measure(const std::string& name, int elements, const std::function<void()>& f) {
+	const std::size_t before{AllocCounter::getAllocations()};
+	const auto start{std::chrono::steady_clock::now()};
+
+	f();
+
+	const auto end{std::chrono::steady_clock::now()};
+	const std::size_t allocations{AllocCounter::getAllocations() - before};
+
+	std::cout << name << ": "
+		<< std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+		<< allocations << " allocations, "
+		<< static_cast<double>(allocations) / elements << " per element" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	const int n{argc > 1 ? atoi(argv[1]) : 60};
+
+	DomainInterface* u{DomainBuilder::intRange(0, n)};
+	DomainInterface* uxu{DomainBuilder::combine(u, u)};
+
+	// A fuzzy equivalence: reflexive, symmetric and max-min transitive
+	MutableFuzzySet r1(uxu);
+	MutableFuzzySet r2(uxu);
+	for (int x{0}; x < n; ++x) {
+		for (int y{0}; y < n; ++y) {
+			r1.set({x, y}, x == y ? 1.0 : 0.5);
+			r2.set({x, y}, (x + y) % 10 / 10.0);
+		}
+	}
+
+	const int card{uxu->getCardinality()};
+	FuzzyBinaryFunction* or_function{Operations::zadehOr()};
+	FuzzyUnaryFunction*  not_function{Operations::zadehNot()};
+
+	measure("elementForIndex", card, [&]() {
+		for (int i{0}; i < card; ++i) {
+			uxu->elementForIndex(i);
+		}
+	});
+	measure("unaryOperation", card, [&]() {
+		Operations::unaryOperation(&r1, not_function);
+	});
+	measure("binaryOperation", card, [&]() {
+		Operations::binaryOperation(&r1, &r2, or_function);
+	});
+
+	// After the first tick the arena's blocks are reused, so a tick doesn't allocate
+	Arena arena;
+	const auto tick{[&]() {
+		arena.reset();
+		Operations::binaryOperation(arena, Operations::unaryOperation(arena, &r1, not_function).get(), &r2, or_function);
+	}};
+	tick();
+	measure("operations in an arena", card, tick);
+
+	// The same chain eagerly, with a set per step, and fused, with only the result
+	FuzzyBinaryFunction* snorm_function{Operations::hamacherSNorm(0.5)};
+	FuzzySetInterface* eager{nullptr};
+	FuzzySetInterface* fused{nullptr};
+	measure("eager not, or, hamacher", card, [&]() {
+		eager = Operations::binaryOperation(
+			Operations::binaryOperation(Operations::unaryOperation(&r1, not_function), &r2, or_function),
+			&r1,
+			snorm_function
+		);
+	});
+	measure("fused not, or, hamacher", card, [&]() {
+		fused = Lazy::materialize(Lazy::combine(snorm_function, (!Lazy::set(&r1)) | Lazy::set(&r2), Lazy::set(&r1)));
+	});
+	for (int i{0}; i < card; ++i) {
+		if (eager->getValueAtIndex(i) != fused->getValueAtIndex(i)) {
+			fail("the fused chain differs at " + std::to_string(i));
+			break;
+		}
+	}
+
+	// Banded relations stored sparsely, with thresholds, and the same memberships stored densely
+	SparseFuzzySet band1(uxu, 0.1);
+	SparseFuzzySet band2(uxu, 0.2);
+	for (int x{0}; x < n; ++x) {
+		for (int y{0}; y < n; ++y) {
+			const int distance{x > y ? x - y : y - x};
+			if (distance <= 2) {
+				band1.set({x, y}, (x * 7 + y * 3) % 10 / 10.0);
+			}
+			if (distance <= 3) {
+				band2.set({x, y}, (x * 3 + y * 5) % 10 / 10.0);
+			}
+		}
+	}
+	MutableFuzzySet dense1(uxu);
+	MutableFuzzySet dense2(uxu);
+	for (int i{0}; i < card; ++i) {
+		dense1.setAtIndex(i, band1.getValueAtIndex(i));
+		dense2.setAtIndex(i, band2.getValueAtIndex(i));
+	}
+
+	measure("sparse binaryOperation", band1.getNumberOfNonZeros() + band2.getNumberOfNonZeros(), [&]() {
+		Operations::binaryOperation(&band1, &band2, or_function);
+	});
+	for (FuzzyBinaryFunction* f : {
+		or_function,
+		Operations::zadehAnd(),
+		Operations::hamacherTNorm(0.5),
+		snorm_function
+	}) {
+		FuzzySetInterface* sparse{Operations::binaryOperation(&band1, &band2, f)};
+		FuzzySetInterface* dense{Operations::binaryOperation(&dense1, &dense2, f)};
+		for (int i{0}; i < card; ++i) {
+			if (sparse->getValueAtIndex(i) != dense->getValueAtIndex(i)) {
+				fail("the sparse and the dense operation differ at " + std::to_string(i));
+				break;
+			}
+		}
+	}
+
+	measure("isReflexive", n, [&]() {
+		Relations::isReflexive(&r1);
+	});
+	measure("isSymmetric", card, [&]() {
+		Relations::isSymmetric(&r1);
+	});
+	measure("isMaxMinTransitive", card * n, [&]() {
+		Relations::isMaxMinTransitive(&r1);
+	});
+	measure("compositionOfBinaryRelations", card * n, [&]() {
+		Relations::compositionOfBinaryRelations(&r1, &r2);
+	});
+
+	// A similarity relation whose closure needs several squarings
+	MutableFuzzySet similarity(uxu);
+	for (int x{0}; x < n; ++x) {
+		for (int y{0}; y < n; ++y) {
+			const int distance{x > y ? x - y : y - x};
+			similarity.set({x, y}, distance == 0 ? 1.0 : distance == 1 ? 0.5 + 0.4 * (x + y) / (2.0 * n) : 0.0);
+		}
+	}
+
+	FuzzySetInterface* closure{nullptr};
+	measure("transitiveClosure", card * n, [&]() {
+		closure = Relations::transitiveClosure(&similarity);
+	});
+	measure("isFuzzyEquivalence", card * n, [&]() {
+		if (!Relations::isFuzzyEquivalence(closure)) {
+			fail("the closure isn't a fuzzy equivalence");
+		}
+	});
+	measure("equivalenceClasses", card, [&]() {
+		std::cout << Relations::equivalenceClasses(closure, 0.7).size() << " classes" << std::endl;
+	});
+
+
+	checkAnalysis(&r1, "r1");
+	checkAnalysis(&r2, "r2");
+	checkAnalysis(&similarity, "similarity");
+	checkAnalysis(closure, "closure");
+
+	// Small random relations, made reflexive or symmetric at random, so that every combination of properties occurs
+	std::mt19937 generator(7);
+	DomainInterface* v{DomainBuilder::intRange(0, 5)};
+	DomainInterface* vxv{DomainBuilder::combine(v, v)};
+	const double levels[]{0.0, 0.3, 0.5, 1.0};
+	for (int run{0}; run < 200; ++run) {
+		MutableFuzzySet random(vxv);
+		const bool reflexive{generator() % 2 == 0};
+		const bool symmetric{generator() % 2 == 0};
+		for (int x{0}; x < 5; ++x) {
+			for (int y{0}; y < 5; ++y) {
+				random.set({x, y}, x == y && reflexive ? 1.0 : levels[generator() % 4]);
+			}
+		}
+		if (symmetric) {
+			for (int x{0}; x < 5; ++x) {
+				for (int y{0}; y < x; ++y) {
+					random.set({y, x}, random.getValueAt({x, y}));
+				}
+			}
+		}
+		checkAnalysis(&random, "random relation " + std::to_string(run));
+	}
+
+	checkProjections(generator);
+	checkAlphaCuts(generator);
+
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#include "compiled_rule_base.hh"
+#include "defuzzifier.hh"
+#include "defuzzifier_coa.hh"
+#include "fuzzy_system.hh"
+#include "fuzzy_system_min.hh"
+#include "fuzzy_system_product.hh"
+#include "rules.hh"
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Inputs = std::array<int, CompiledRuleBase::INPUTS>;
+
+static double measure(const std::function<void()>& f) {
+	const auto start{std::chrono::steady_clock::now()};
+	f();
+	const auto end{std::chrono::steady_clock::now()};
+
+	return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+static void compare(
+	const std::string& name,
+	const std::vector<std::array<IntUnaryFunction const*, 7>>& rules,
+	CompiledRuleBase::Implication implication,
+	const FuzzySystem& evaluated,
+	const FuzzySystem& tabulated,
+	const std::vector<Inputs>& inputs
+) {
+	const auto ranges{Rules::get_input_ranges()};
+
+	CompiledRuleBase plain(rules, -400, 400);
+	CompiledRuleBase cached(rules, -400, 400);
+	const double build{measure([&]() {
+		cached.buildLookupTables(ranges);
+	})};
+
+	std::vector<double> strengths(plain.getNumberOfConsequents());
+	const auto fire{[&](const CompiledRuleBase& base) {
+		return measure([&]() {
+			for (const Inputs& in : inputs) {
+				base.fire(in, implication, strengths.data());
+			}
+		}) / inputs.size();
+	}};
+
+	int mismatches{0};
+	const auto infer{[&](const FuzzySystem& system, std::vector<int>& results) {
+		return measure([&]() {
+			for (const Inputs& in : inputs) {
+				results.push_back(system.infer(in[0], in[1], in[2], in[3], in[4], in[5]));
+			}
+		}) / inputs.size();
+	}};
+
+	std::vector<int> evaluated_results;
+	std::vector<int> tabulated_results;
+	evaluated_results.reserve(inputs.size());
+	tabulated_results.reserve(inputs.size());
+
+	const double fire_evaluated{fire(plain)};
+	const double fire_tabulated{fire(cached)};
+	const double infer_evaluated{infer(evaluated, evaluated_results)};
+	const double infer_tabulated{infer(tabulated, tabulated_results)};
+	for (std::size_t i{0}; i < inputs.size(); ++i) {
+		mismatches += evaluated_results[i] != tabulated_results[i];
+	}
+
+	std::cout << name << ": "
+		<< cached.getLookupTablesSize() / 1024.0 << " KiB of tables built in "
+		<< build / 1e6 << " ms" << std::endl
+		<< "\tfire:  " << fire_evaluated << " ns evaluated, " << fire_tabulated << " ns tabulated" << std::endl
+		<< "\tinfer: " << infer_evaluated << " ns evaluated, " << infer_tabulated << " ns tabulated, "
+		<< mismatches << " mismatches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	const int n{argc > 1 ? atoi(argv[1]) : 100000};
+
+	// Random inputs within the ranges, the tables are then hit on every lookup
+	std::mt19937 generator(42);
+	std::vector<Inputs> inputs(n);
+	const auto ranges{Rules::get_input_ranges()};
+	for (Inputs& in : inputs) {
+		for (int i{0}; i < CompiledRuleBase::INPUTS; ++i) {
+			in[i] = std::uniform_int_distribution<int>(ranges[i].first, ranges[i].last)(generator);
+		}
+	}
+
+	Defuzzifier* def{new DefuzzifierCOA()};
+	const auto accel{Rules::get_for_accel()};
+	const auto omega{Rules::get_for_omega()};
+
+	compare(
+		"product accel", accel, CompiledRuleBase::Implication::PRODUCT,
+		FuzzySystemProduct(def, accel), FuzzySystemProduct(def, accel, ranges), inputs
+	);
+	compare(
+		"product omega", omega, CompiledRuleBase::Implication::PRODUCT,
+		FuzzySystemProduct(def, omega), FuzzySystemProduct(def, omega, ranges), inputs
+	);
+	compare(
+		"min accel", accel, CompiledRuleBase::Implication::MIN,
+		FuzzySystemMin(def, accel), FuzzySystemMin(def, accel, ranges), inputs
+	);
+	compare(
+		"min omega", omega, CompiledRuleBase::Implication::MIN,
+		FuzzySystemMin(def, omega), FuzzySystemMin(def, omega, ranges), inputs
+	);
+
+	return 0;
+}
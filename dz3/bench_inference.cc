@@ -0,0 +1,153 @@
+#include "compiled_rule_base.hh"
+#include "defuzzifier.hh"
+#include "defuzzifier_coa.hh"
+#include "defuzzifier_analytic_coa.hh"
+#include "defuzzifier_mom.hh"
+#include "defuzzifier_bisector.hh"
+#include "defuzzifier_height.hh"
+#include "defuzzifier_sugeno.hh"
+#include "fuzzy_system.hh"
+#include "fuzzy_system_product.hh"
+#include "fuzzy_system_min.hh"
+#include "rules.hh"
+#include "alloc_counter.hh"
+#include "profiler.hh"
+#include "fast_io.hh"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using Inputs = std::array<int, CompiledRuleBase::INPUTS>;
+
+// The ticks in the format the simulator sends, one tuple of inputs per line
+static std::vector<Inputs> readTrace(const char* path) {
+	const int fd{open(path, O_RDONLY)};
+	if (fd < 0) {
+		throw std::invalid_argument("can't open the trace " + std::string(path));
+	}
+
+	std::vector<Inputs> inputs;
+	FastReader reader(fd);
+	Inputs in;
+	while (reader.nextInts(in)) {
+		inputs.push_back(in);
+	}
+	close(fd);
+
+	return inputs;
+}
+
+static Defuzzifier* makeDefuzzifier(const std::string& name) {
+	if (name == "coa") {
+		return new DefuzzifierCOA();
+	} else if (name == "analytic") {
+		return new DefuzzifierAnalyticCOA();
+	} else if (name == "mom") {
+		return new DefuzzifierMOM();
+	} else if (name == "bisector") {
+		return new DefuzzifierBisector();
+	} else if (name == "height") {
+		return new DefuzzifierHeight();
+	} else if (name == "sugeno") {
+		return new DefuzzifierSugeno();
+	}
+
+	throw std::invalid_argument("unknown defuzzifier " + name);
+}
+
+// The latency below which the fraction of the sorted samples falls
+static std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double fraction) {
+	const auto rank{static_cast<std::size_t>(fraction * (sorted.size() - 1))};
+	return sorted[rank];
+}
+
+// Replays the trace through the accel and omega systems and prints the statistics of the ticks
+static void replay(
+	const std::string& name,
+	const FuzzySystem& accel,
+	const FuzzySystem& omega,
+	const std::vector<Inputs>& inputs
+) {
+	std::vector<std::uint64_t> latencies(inputs.size());
+	long long checksum{0};
+
+	const std::size_t allocations{AllocCounter::getAllocations()};
+	const auto start{std::chrono::steady_clock::now()};
+	for (std::size_t i{0}; i < inputs.size(); ++i) {
+		const Inputs& in{inputs[i]};
+		const auto tick_start{std::chrono::steady_clock::now()};
+		const int a{accel.infer(in[0], in[1], in[2], in[3], in[4], in[5])};
+		const int w{omega.infer(in[0], in[1], in[2], in[3], in[4], in[5])};
+		const auto tick_end{std::chrono::steady_clock::now()};
+
+		latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(tick_end - tick_start).count();
+		checksum += a * 31 + w;
+	}
+	const auto end{std::chrono::steady_clock::now()};
+	const std::size_t allocated{AllocCounter::getAllocations() - allocations};
+
+	std::sort(latencies.begin(), latencies.end());
+	const double seconds{std::chrono::duration<double>(end - start).count()};
+
+	std::cout << name << ": "
+		<< inputs.size() / seconds << " ticks/s, "
+		<< "p50 " << percentile(latencies, 0.5) << " ns, "
+		<< "p99 " << percentile(latencies, 0.99) << " ns, "
+		<< "p999 " << percentile(latencies, 0.999) << " ns, "
+		<< static_cast<double>(allocated) / inputs.size() << " allocations per tick, "
+		<< "checksum " << checksum << std::endl;
+}
+
+/**
+ * Replays a recorded trace of sensor tuples, e.g. one written by trace_gen,
+ * through FuzzySystemProduct and FuzzySystemMin with the given defuzzifier, and
+ * reports the throughput, the percentiles of the latency of a tick (accel and
+ * omega) and the heap allocations per tick. With --profile the systems record
+ * every tick into an enabled profiler, to measure what the profiling costs.
+ * Usage: bench_inference TRACE [coa|analytic|mom|bisector|height|sugeno] [--profile]
+ */
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		std::cerr << "Usage: " << argv[0] << " TRACE [coa|analytic|mom|bisector|height|sugeno] [--profile]" << std::endl;
+		return 1;
+	}
+
+	const std::vector<Inputs> inputs{readTrace(argv[1])};
+	if (inputs.empty()) {
+		throw std::invalid_argument("there are no inputs to replay");
+	}
+	const Defuzzifier* df{makeDefuzzifier(argc > 2 ? argv[2] : "coa")};
+	const bool profile{argc > 3 && std::string(argv[3]) == "--profile"};
+	const auto ranges{Rules::get_input_ranges()};
+
+	FuzzySystemProduct product_accel(df, Rules::get_for_accel(), ranges);
+	FuzzySystemProduct product_omega(df, Rules::get_for_omega(), ranges);
+	FuzzySystemMin min_accel(df, Rules::get_for_accel(), ranges);
+	FuzzySystemMin min_omega(df, Rules::get_for_omega(), ranges);
+
+	Profiler accel_profiler(product_accel.getNumberOfRules());
+	Profiler omega_profiler(product_omega.getNumberOfRules());
+	if (profile) {
+		Profiler::setAllocationCounter(AllocCounter::getThreadAllocations);
+		accel_profiler.setEnabled(true);
+		omega_profiler.setEnabled(true);
+		product_accel.setProfiler(&accel_profiler);
+		min_accel.setProfiler(&accel_profiler);
+		product_omega.setProfiler(&omega_profiler);
+		min_omega.setProfiler(&omega_profiler);
+	}
+
+	replay("product", product_accel, product_omega, inputs);
+	replay("min", min_accel, min_omega, inputs);
+
+	return 0;
+}
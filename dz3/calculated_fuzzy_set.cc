@@ -1,6 +1,10 @@
 #include "calculated_fuzzy_set.hh"
+#include "simple_domain.hh"
 
 #include <stdexcept>
+#include <array>
+#include <numeric>
+#include <algorithm>
 
 CalculatedFuzzySet::CalculatedFuzzySet(DomainInterface* d, IntUnaryFunction* f):
 	domain{d}, function{f} {
@@ -25,3 +29,33 @@ double CalculatedFuzzySet::getValueAt(const DomainElement& e) const {
 	}
 	return function->valueAt(e.getComponentValue(0));
 }
+
+double CalculatedFuzzySet::getValueAtIndex(int index) const {
+	return function->valueAt(domain->elementForIndex(index).getComponentValue(0));
+}
+
+void CalculatedFuzzySet::copyMemberships(std::span<double> out) const {
+	const int card{domain->getCardinality()};
+	if (out.size() != static_cast<std::size_t>(card)) {
+		throw std::invalid_argument("the output must have the domain's cardinality");
+	}
+
+	// The domain's values are laid out in chunks and evaluated in one batch each
+	const SimpleDomain* simple{dynamic_cast<const SimpleDomain*>(domain)};
+	std::array<int, IntUnaryFunction::BATCH_SIZE> values;
+	for (int begin{0}; begin < card; begin += IntUnaryFunction::BATCH_SIZE) {
+		const int n{std::min(IntUnaryFunction::BATCH_SIZE, card - begin)};
+		if (simple != nullptr) {
+			std::iota(values.begin(), values.begin() + n, simple->getFirst() + begin);
+		} else {
+			for (int i{0}; i < n; ++i) {
+				values[i] = domain->elementForIndex(begin + i).getComponentValue(0);
+			}
+		}
+
+		function->valuesAt(
+			std::span<const int>(values.data(), n),
+			out.subspan(begin, n)
+		);
+	}
+}
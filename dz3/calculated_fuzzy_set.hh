@@ -10,6 +10,8 @@ public:
 
 	DomainInterface* getDomain() override;
 	double           getValueAt(const DomainElement&) const override;
+	double           getValueAtIndex(int index) const override;
+	void             copyMemberships(std::span<double> out) const override;
 private:
 	DomainInterface*  domain;
 	IntUnaryFunction* function;
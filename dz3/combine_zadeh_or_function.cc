@@ -1,6 +1,8 @@
 #include "combine_zadeh_or_function.hh"
 
 #include <stdexcept>
+#include <array>
+#include <algorithm>
 
 CombineZadehOrFunction::CombineZadehOrFunction(
 	IntUnaryFunction const* aa,
@@ -24,3 +26,30 @@ static double max(double a, double b) {
 double CombineZadehOrFunction::valueAt(int x) const {
 	return max(a->valueAt(x), b->valueAt(x));
 }
+
+std::vector<Trapezoid> CombineZadehOrFunction::getTrapezoids() const {
+	std::vector<Trapezoid> result{a->getTrapezoids()};
+	const std::vector<Trapezoid> other{b->getTrapezoids()};
+	result.insert(result.end(), other.begin(), other.end());
+
+	return result;
+}
+
+void CombineZadehOrFunction::valuesAt(std::span<const int> in, std::span<double> out) const {
+	if (out.size() < in.size()) {
+		throw std::invalid_argument("the output must be at least as large as the input");
+	}
+
+	a->valuesAt(in, out);
+
+	// The second function is evaluated in chunks, into a buffer on the stack
+	std::array<double, BATCH_SIZE> other;
+	for (std::size_t begin{0}; begin < in.size(); begin += BATCH_SIZE) {
+		const std::size_t n{std::min<std::size_t>(BATCH_SIZE, in.size() - begin)};
+		b->valuesAt(in.subspan(begin, n), other);
+
+		for (std::size_t i{0}; i < n; ++i) {
+			out[begin + i] = max(out[begin + i], other[i]);
+		}
+	}
+}
@@ -11,7 +11,9 @@ public:
 		IntUnaryFunction const* b
 	);
 
-	double valueAt(int) const override;
+	double                 valueAt(int) const override;
+	void                   valuesAt(std::span<const int> in, std::span<double> out) const override;
+	std::vector<Trapezoid> getTrapezoids() const override;
 private:
 	IntUnaryFunction const* a;
 	IntUnaryFunction const* b;
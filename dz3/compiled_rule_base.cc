@@ -0,0 +1,489 @@
+#include "compiled_rule_base.hh"
+
+#include <stdexcept>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+
+CompiledRuleBase::CompiledRuleBase(
+	const std::vector<std::array<IntUnaryFunction const*, 7>>& rules,
+	int f,
+	int l
+): CompiledRuleBase(std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>>{rules}, f, l) {
+}
+
+CompiledRuleBase::CompiledRuleBase(
+	const std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>>& outputs,
+	int f,
+	int l
+): first{f}, last{l} {
+	if (first > last) {
+		throw std::domain_error("the first bound must be less than the last bound");
+	}
+
+	term_first.push_back(0);
+
+	std::map<IntUnaryFunction const*, int> terms;
+	const auto termIndex{[&](IntUnaryFunction const* func) {
+		if (func == nullptr) {
+			throw std::invalid_argument("the rule contains a null function");
+		}
+
+		const auto iter{terms.find(func)};
+		if (iter != terms.end()) {
+			return iter->second;
+		}
+
+		const int index{addTerm(func)};
+		terms.emplace(func, index);
+		return index;
+	}};
+
+	const auto isConstantOne{[this](int term) {
+		if (term_first[term + 1] - term_first[term] != 1) {
+			return false;
+		}
+
+		const int p{term_first[term]};
+		return Trapezoid{piece_a[p], piece_b[p], piece_c[p], piece_d[p]}.isConstantOne();
+	}};
+
+	const auto addConsequent{[this](IntUnaryFunction const* consequent, int term) {
+		consequent_trapezoids.push_back(consequent->getTrapezoids());
+		for (int y{first}; y < last; ++y) {
+			consequents.push_back(termValueAt(term, y));
+		}
+	}};
+
+	table.compile(outputs, termIndex, isConstantOne, addConsequent);
+
+	buildActivationIndex();
+	summarizeConsequents();
+}
+
+// Vectors are written as their size and their raw elements
+template<typename T>
+static void writeVector(std::ostream& out, const std::vector<T>& v) {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	const std::uint64_t size{v.size()};
+	out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	out.write(reinterpret_cast<const char*>(v.data()), size * sizeof(T));
+}
+
+template<typename T>
+static std::vector<T> readVector(std::istream& in) {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	std::uint64_t size{0};
+	in.read(reinterpret_cast<char*>(&size), sizeof(size));
+	if (!in || size > (std::uint64_t{1} << 32)) {
+		throw std::invalid_argument("the compiled rule base is malformed");
+	}
+
+	std::vector<T> v(size);
+	in.read(reinterpret_cast<char*>(v.data()), size * sizeof(T));
+	if (!in) {
+		throw std::invalid_argument("the compiled rule base is malformed");
+	}
+
+	return v;
+}
+
+int CompiledRuleBase::addTerm(IntUnaryFunction const* f) {
+	for (const Trapezoid& t : f->getTrapezoids()) {
+		piece_a.push_back(t.a);
+		piece_b.push_back(t.b);
+		piece_c.push_back(t.c);
+		piece_d.push_back(t.d);
+		piece_rise_step.push_back(1.0 / (t.b - t.a));
+		piece_fall_step.push_back(1.0 / (t.d - t.c));
+	}
+	term_first.push_back(piece_a.size());
+
+	return term_first.size() - 2;
+}
+
+double CompiledRuleBase::termValueAt(int term, int x) const {
+	double max{0.0};
+	for (int p{term_first[term]}; p < term_first[term + 1]; ++p) {
+		double rise{1.0};
+		if (x < piece_b[p]) {
+			rise = x <= piece_a[p] ? 0.0 : (x - piece_a[p]) * piece_rise_step[p];
+		}
+		double fall{1.0};
+		if (x > piece_c[p]) {
+			fall = x >= piece_d[p] ? 0.0 : 1.0 - (x - piece_c[p]) * piece_fall_step[p];
+		}
+
+		const double val{rise * fall};
+		if (val > max) {
+			max = val;
+		}
+	}
+
+	return max;
+}
+
+int CompiledRuleBase::getNumberOfRules() const {
+	return table.getNumberOfRules();
+}
+
+int CompiledRuleBase::getNumberOfConsequents() const {
+	return consequent_trapezoids.size();
+}
+
+int CompiledRuleBase::getNumberOfOutputs() const {
+	return table.getNumberOfOutputs();
+}
+
+int CompiledRuleBase::getFirstConsequent(int output) const {
+	return table.getFirstConsequent(output);
+}
+
+int CompiledRuleBase::getFirst() const {
+	return first;
+}
+
+int CompiledRuleBase::getLast() const {
+	return last;
+}
+
+int CompiledRuleBase::getOutputCardinality() const {
+	return last - first;
+}
+
+const std::vector<Trapezoid>& CompiledRuleBase::getConsequentTrapezoids(int consequent) const {
+	return consequent_trapezoids.at(consequent);
+}
+
+double CompiledRuleBase::getConsequentCentroid(int consequent) const {
+	return consequent_centroids.at(consequent);
+}
+
+double CompiledRuleBase::getConsequentPeak(int consequent) const {
+	return consequent_peaks.at(consequent);
+}
+
+double CompiledRuleBase::getConsequentHeight(int consequent) const {
+	return consequent_heights.at(consequent);
+}
+
+void CompiledRuleBase::summarizeConsequents() {
+	consequent_centroids.clear();
+	consequent_peaks.clear();
+	consequent_heights.clear();
+
+	for (int c{0}; c < getNumberOfConsequents(); ++c) {
+		double sum_upper{0};
+		double sum_lower{0};
+		double max{0};
+		double sum_maxima{0};
+		int maxima{0};
+		for (int i{0}; i < getOutputCardinality(); ++i) {
+			const double mi{consequentValueAt(c, i)};
+			const int x{first + i};
+
+			sum_upper += x * mi;
+			sum_lower += mi;
+			if (mi > max) {
+				max = mi;
+				sum_maxima = 0;
+				maxima = 0;
+			}
+			if (mi == max) {
+				sum_maxima += x;
+				++maxima;
+			}
+		}
+
+		consequent_centroids.push_back(sum_lower > 0 ? sum_upper / sum_lower : 0);
+		consequent_peaks.push_back(max > 0 ? sum_maxima / maxima : 0);
+		consequent_heights.push_back(max);
+	}
+}
+
+void CompiledRuleBase::buildActivationIndex() {
+	// The support of a piece, where termValueAt is non-zero, is [min(b, a + 1), max(c + 1, d)).
+	// The bounds are computed wider than int, so that the open shoulders don't overflow
+	table.buildActivationIndex([this](int term) {
+		RuleTable::Supports intervals;
+		for (int p{term_first[term]}; p < term_first[term + 1]; ++p) {
+			intervals.emplace_back(
+				std::min<long long>(piece_b[p], piece_a[p] + 1LL),
+				std::max<long long>(piece_c[p] + 1LL, piece_d[p])
+			);
+		}
+		return intervals;
+	});
+}
+
+int CompiledRuleBase::fire(
+	const std::array<int, INPUTS>& inputs,
+	Implication implication,
+	double* strengths,
+	double* rule_strengths
+) const {
+	// The rows of the inputs, or null for an input outside of its range or without tables
+	std::array<const double*, INPUTS> rows;
+	std::array<double, INPUTS> real_inputs;
+	for (int input{0}; input < INPUTS; ++input) {
+		const Range& range{lookup_ranges[input]};
+		const int x{inputs[input]};
+
+		real_inputs[input] = x;
+		rows[input] = nullptr;
+		if (!lookup_values.empty() && x >= range.first && x <= range.last) {
+			rows[input] = lookup_values.data() + lookup_first[input]
+				+ static_cast<std::size_t>(x - range.first) * lookup_stride[input];
+		}
+	}
+
+	return table.fire(real_inputs, implication, [&](int antecedent) {
+		const int input{table.getAntecedentInput(antecedent)};
+		const double* row{rows[input]};
+		return row != nullptr
+			? row[lookup_slot[antecedent]]
+			: termValueAt(table.getAntecedentTerm(antecedent), inputs[input]);
+	}, strengths, rule_strengths);
+}
+
+void CompiledRuleBase::termValuesAt(int term, const int* x, int n, double* out) const {
+	std::fill(out, out + n, 0.0);
+
+	for (int p{term_first[term]}; p < term_first[term + 1]; ++p) {
+		const int a{piece_a[p]};
+		const int b{piece_b[p]};
+		const int c{piece_c[p]};
+		const int d{piece_d[p]};
+		const double rise_step{piece_rise_step[p]};
+		const double fall_step{piece_fall_step[p]};
+
+		// A degenerate ramp has an infinite step, the selects and the argument order
+		// of the clamps keep its infinities and NaNs out of the result
+		for (int j{0}; j < n; ++j) {
+			const double rise_ramp{std::max(0.0, (static_cast<double>(x[j]) - a) * rise_step)};
+			const double fall_ramp{std::min(1.0, 1.0 - (static_cast<double>(x[j]) - c) * fall_step)};
+			const double rise{x[j] >= b ? 1.0 : rise_ramp};
+			const double fall{x[j] > c && x[j] >= d ? 0.0 : fall_ramp};
+
+			const double val{rise * fall};
+			out[j] = val > out[j] ? val : out[j];
+		}
+	}
+}
+
+void CompiledRuleBase::buildLookupTables(const std::array<Range, INPUTS>& ranges) {
+	for (const Range& range : ranges) {
+		if (range.first > range.last) {
+			throw std::domain_error("the first bound of a range must not be greater than the last bound");
+		}
+	}
+
+	lookup_ranges = ranges;
+	lookup_stride.fill(0);
+	lookup_slot.resize(table.getNumberOfAntecedents());
+	for (int i{0}; i < table.getNumberOfAntecedents(); ++i) {
+		lookup_slot[i] = lookup_stride[table.getAntecedentInput(i)]++;
+	}
+
+	std::size_t size{0};
+	for (int input{0}; input < INPUTS; ++input) {
+		lookup_first[input] = size;
+		size += static_cast<std::size_t>(ranges[input].last - ranges[input].first + 1) * lookup_stride[input];
+	}
+
+	lookup_values.assign(size, 0.0);
+	for (int i{0}; i < table.getNumberOfAntecedents(); ++i) {
+		const int input{table.getAntecedentInput(i)};
+		const Range& range{ranges[input]};
+
+		double* value{lookup_values.data() + lookup_first[input] + lookup_slot[i]};
+		for (int x{range.first}; x <= range.last; ++x) {
+			*value = termValueAt(table.getAntecedentTerm(i), x);
+			value += lookup_stride[input];
+		}
+	}
+}
+
+bool CompiledRuleBase::hasLookupTables() const {
+	return !lookup_values.empty();
+}
+
+std::size_t CompiledRuleBase::getLookupTablesSize() const {
+	return lookup_values.size() * sizeof(double);
+}
+
+void CompiledRuleBase::fireBatch(
+	const std::array<const int*, INPUTS>& columns,
+	int n,
+	Implication implication,
+	double* strengths
+) const {
+	if (n < 0 || n > BATCH_SIZE) {
+		throw std::invalid_argument("the number of tuples must be between 0 and BATCH_SIZE");
+	}
+
+	// Row i holds the antecedent i for every tuple
+	thread_local std::vector<double> antecedent_values;
+	antecedent_values.resize(table.getNumberOfAntecedents() * BATCH_SIZE);
+
+	for (int i{0}; i < table.getNumberOfAntecedents(); ++i) {
+		const int input{table.getAntecedentInput(i)};
+		const int* x{columns[input]};
+		double* values{antecedent_values.data() + i * BATCH_SIZE};
+
+		if (lookup_values.empty()) {
+			termValuesAt(table.getAntecedentTerm(i), x, n, values);
+			continue;
+		}
+
+		const Range& range{lookup_ranges[input]};
+		const double* lookup{lookup_values.data() + lookup_first[input] + lookup_slot[i]};
+		for (int j{0}; j < n; ++j) {
+			values[j] = x[j] >= range.first && x[j] <= range.last
+				? lookup[static_cast<std::size_t>(x[j] - range.first) * lookup_stride[input]]
+				: termValueAt(table.getAntecedentTerm(i), x[j]);
+		}
+	}
+
+	std::fill(strengths, strengths + getNumberOfConsequents() * n, 0.0);
+
+	std::array<double, BATCH_SIZE> strength;
+	for (int r{0}; r < getNumberOfRules(); ++r) {
+		std::fill(strength.begin(), strength.begin() + n, 1.0);
+		for (const int a : table.getRuleAntecedents(r)) {
+			const double* values{antecedent_values.data() + a * BATCH_SIZE};
+			if (implication == Implication::PRODUCT) {
+				for (int j{0}; j < n; ++j) {
+					strength[j] *= values[j];
+				}
+			} else {
+				for (int j{0}; j < n; ++j) {
+					strength[j] = values[j] < strength[j] ? values[j] : strength[j];
+				}
+			}
+		}
+
+		double* s{strengths + table.getRuleConsequent(r) * n};
+		for (int j{0}; j < n; ++j) {
+			s[j] = std::max(s[j], strength[j]);
+		}
+	}
+}
+
+void CompiledRuleBase::write(std::ostream& out) const {
+	const std::array<int, 2> bounds{first, last};
+	out.write(reinterpret_cast<const char*>(bounds.data()), sizeof(bounds));
+
+	writeVector(out, term_first);
+	writeVector(out, piece_a);
+	writeVector(out, piece_b);
+	writeVector(out, piece_c);
+	writeVector(out, piece_d);
+	writeVector(out, piece_rise_step);
+	writeVector(out, piece_fall_step);
+	const RuleTable::Arrays& arrays{table.getArrays()};
+	writeVector(out, arrays.antecedent_input);
+	writeVector(out, arrays.antecedent_term);
+	writeVector(out, arrays.rule_first);
+	writeVector(out, arrays.rule_antecedents);
+	writeVector(out, arrays.rule_consequent);
+	writeVector(out, arrays.output_first_consequent);
+	writeVector(out, consequents);
+
+	std::vector<int> trapezoid_counts;
+	std::vector<Trapezoid> trapezoids;
+	for (const std::vector<Trapezoid>& t : consequent_trapezoids) {
+		trapezoid_counts.push_back(t.size());
+		trapezoids.insert(trapezoids.end(), t.begin(), t.end());
+	}
+	writeVector(out, trapezoid_counts);
+	writeVector(out, trapezoids);
+
+	if (!out) {
+		throw std::invalid_argument("can't write the compiled rule base");
+	}
+}
+
+CompiledRuleBase CompiledRuleBase::read(std::istream& in) {
+	CompiledRuleBase base;
+
+	std::array<int, 2> bounds;
+	in.read(reinterpret_cast<char*>(bounds.data()), sizeof(bounds));
+	base.first = bounds[0];
+	base.last = bounds[1];
+
+	base.term_first = readVector<int>(in);
+	base.piece_a = readVector<int>(in);
+	base.piece_b = readVector<int>(in);
+	base.piece_c = readVector<int>(in);
+	base.piece_d = readVector<int>(in);
+	base.piece_rise_step = readVector<double>(in);
+	base.piece_fall_step = readVector<double>(in);
+	RuleTable::Arrays arrays;
+	arrays.antecedent_input = readVector<int>(in);
+	arrays.antecedent_term = readVector<int>(in);
+	arrays.rule_first = readVector<int>(in);
+	arrays.rule_antecedents = readVector<int>(in);
+	arrays.rule_consequent = readVector<int>(in);
+	arrays.output_first_consequent = readVector<int>(in);
+	base.consequents = readVector<double>(in);
+
+	const std::vector<int> trapezoid_counts{readVector<int>(in)};
+	const std::vector<Trapezoid> trapezoids{readVector<Trapezoid>(in)};
+
+	// Every index must point into its table, so that a malformed image can't be used
+	const auto within{[](const std::vector<int>& indices, std::size_t size) {
+		return std::all_of(indices.begin(), indices.end(), [size](int i) {
+			return i >= 0 && static_cast<std::size_t>(i) < size;
+		});
+	}};
+	const std::size_t pieces{base.piece_a.size()};
+	const std::size_t rules{arrays.rule_consequent.size()};
+	const std::size_t terms{base.term_first.empty() ? 0 : base.term_first.size() - 1};
+	const bool valid{
+		base.first <= base.last
+		&& !base.term_first.empty() && base.term_first.front() == 0
+		&& static_cast<std::size_t>(base.term_first.back()) == pieces
+		&& std::is_sorted(base.term_first.begin(), base.term_first.end())
+		&& base.piece_b.size() == pieces && base.piece_c.size() == pieces && base.piece_d.size() == pieces
+		&& base.piece_rise_step.size() == pieces && base.piece_fall_step.size() == pieces
+		&& arrays.antecedent_input.size() == arrays.antecedent_term.size()
+		&& within(arrays.antecedent_input, INPUTS) && within(arrays.antecedent_term, terms)
+		&& arrays.rule_first.size() == rules + 1 && arrays.rule_first.front() == 0
+		&& static_cast<std::size_t>(arrays.rule_first.back()) == arrays.rule_antecedents.size()
+		&& std::is_sorted(arrays.rule_first.begin(), arrays.rule_first.end())
+		&& within(arrays.rule_antecedents, arrays.antecedent_input.size())
+		&& within(arrays.rule_consequent, trapezoid_counts.size())
+		&& arrays.output_first_consequent.size() >= 2 && arrays.output_first_consequent.front() == 0
+		&& static_cast<std::size_t>(arrays.output_first_consequent.back()) == trapezoid_counts.size()
+		&& std::is_sorted(arrays.output_first_consequent.begin(), arrays.output_first_consequent.end())
+		&& base.consequents.size() == trapezoid_counts.size() * (base.last - base.first)
+		&& std::all_of(trapezoid_counts.begin(), trapezoid_counts.end(), [](int c) { return c >= 0; })
+	};
+	if (!valid) {
+		throw std::invalid_argument("the compiled rule base is malformed");
+	}
+
+	base.table = RuleTable(std::move(arrays));
+
+	std::size_t next{0};
+	for (int count : trapezoid_counts) {
+		if (next + count > trapezoids.size()) {
+			throw std::invalid_argument("the compiled rule base is malformed");
+		}
+		base.consequent_trapezoids.emplace_back(trapezoids.begin() + next, trapezoids.begin() + next + count);
+		next += count;
+	}
+	if (next != trapezoids.size()) {
+		throw std::invalid_argument("the compiled rule base is malformed");
+	}
+
+	base.buildActivationIndex();
+	base.summarizeConsequents();
+
+	return base;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "int_unary_function.hh"
+#include "rule_table.hh"
+
+#include <vector>
+#include <array>
+#include <istream>
+#include <ostream>
+
+/**
+ * A rule base flattened into plain arrays of membership function parameters.
+ * Antecedent terms are evaluated once per inference, and the consequent terms
+ * are sampled over the output universe once, at construction. The rules may
+ * infer several outputs over the same universe, which share the antecedents.
+ * The supports of the antecedents are indexed per input, so that inference only
+ * goes through the rules that can have a non-zero strength.
+ */
+class CompiledRuleBase {
+public:
+	using Implication = RuleTable::Implication;
+
+	static constexpr int INPUTS{RuleTable::INPUTS};
+	// The most tuples fired at once by fireBatch
+	static constexpr int BATCH_SIZE{64};
+
+	// Inclusive bounds of an input
+	struct Range {
+		int first;
+		int last;
+	};
+
+	CompiledRuleBase(
+		const std::vector<std::array<IntUnaryFunction const*, 7>>& rules,
+		int first,
+		int last
+	);
+	// Every element of outputs holds the rules of one output
+	CompiledRuleBase(
+		const std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>>& outputs,
+		int first,
+		int last
+	);
+
+	int getNumberOfRules() const;
+	int getNumberOfConsequents() const;
+	int getNumberOfOutputs() const;
+	// Consequents of the output o are [getFirstConsequent(o), getFirstConsequent(o + 1))
+	int getFirstConsequent(int output) const;
+	int getFirst() const;
+	int getLast() const;
+	int getOutputCardinality() const;
+
+	/**
+	 * Tabulates every antecedent over its input's range, so that fire looks the
+	 * memberships up instead of evaluating the terms. Inputs outside of the range
+	 * are still evaluated.
+	 */
+	void buildLookupTables(const std::array<Range, INPUTS>& ranges);
+	bool hasLookupTables() const;
+	// The memory taken by the tables in bytes
+	std::size_t getLookupTablesSize() const;
+
+	/**
+	 * Writes the firing strength of every distinct consequent of every output, the
+	 * maximum over its rules. Returns the number of rules with a non-zero strength.
+	 * The strength of every rule is written to rule_strengths unless it's null.
+	 */
+	int fire(
+		const std::array<int, INPUTS>& inputs,
+		Implication implication,
+		double* strengths,
+		double* rule_strengths = nullptr
+	) const;
+
+	/**
+	 * Fires n <= BATCH_SIZE tuples in one pass over the rules, columns[i][j] is the
+	 * input i of the tuple j. The strength of the consequent c for the tuple j is
+	 * written to strengths[c * n + j], and equals the one written by fire.
+	 */
+	void fireBatch(
+		const std::array<const int*, INPUTS>& columns,
+		int n,
+		Implication implication,
+		double* strengths
+	) const;
+
+	// The consequent's membership at the index of the output universe
+	double consequentValueAt(int consequent, int index) const {
+		return consequents[consequent * getOutputCardinality() + index];
+	}
+	const std::vector<Trapezoid>& getConsequentTrapezoids(int consequent) const;
+	// The center of area, the mean of maxima and the maximum of the consequent sampled over the output universe.
+	// The centroid and the peak of a consequent with a zero height are 0
+	double getConsequentCentroid(int consequent) const;
+	double getConsequentPeak(int consequent) const;
+	double getConsequentHeight(int consequent) const;
+
+	// A binary image of the rule base without the lookup tables, for the same build only
+	void write(std::ostream& out) const;
+	// Reads an image written by write, throws if it's malformed
+	static CompiledRuleBase read(std::istream& in);
+private:
+	CompiledRuleBase() = default;
+
+	// Indexes the rules that can fire by the supports of the terms
+	void buildActivationIndex();
+	// Computes the centroids, the peaks and the heights from the sampled consequents
+	void summarizeConsequents();
+
+	// Adds the function's trapezoids to the term table and returns the term index
+	int addTerm(IntUnaryFunction const* f);
+	double termValueAt(int term, int x) const;
+	// The same values as termValueAt, without branches so that the loops vectorize
+	void termValuesAt(int term, const int* x, int n, double* out) const;
+
+	// Term table, pieces of the term t are [term_first[t], term_first[t + 1])
+	std::vector<int>    term_first;
+	std::vector<int>    piece_a;
+	std::vector<int>    piece_b;
+	std::vector<int>    piece_c;
+	std::vector<int>    piece_d;
+	std::vector<double> piece_rise_step;
+	std::vector<double> piece_fall_step;
+
+	// Row x - ranges[i].first of the input i starts at lookup_first[i] + (x - ranges[i].first) * lookup_stride[i],
+	// the antecedent a is at lookup_slot[a] within the row of its input
+	std::array<Range, INPUTS> lookup_ranges;
+	std::array<std::size_t, INPUTS> lookup_first;
+	std::array<int, INPUTS> lookup_stride;
+	std::vector<int> lookup_slot;
+	std::vector<double> lookup_values;
+
+	// The antecedents, the rules and the consequents over the terms of the term table
+	RuleTable table;
+
+	// Row c holds the consequent c sampled over [first, last)
+	std::vector<double> consequents;
+	std::vector<std::vector<Trapezoid>> consequent_trapezoids;
+	std::vector<double> consequent_centroids;
+	std::vector<double> consequent_peaks;
+	std::vector<double> consequent_heights;
+
+	int first;
+	int last;
+};
@@ -1,19 +1,42 @@
 #include "composite_domain.hh"
 
 #include <stdexcept>
+#include <array>
+#include <vector>
+#include <utility>
 
-CompositeDomain::CompositeDomain(std::initializer_list<DomainInterface*> l): values{l} {
+CompositeDomain::CompositeDomain(std::initializer_list<DomainInterface*> l):
+	CompositeDomain(std::vector<DomainInterface*>(l)) {
 
 }
 
-int CompositeDomain::getCardinality() const {
-	int card{1};
+CompositeDomain::CompositeDomain(std::vector<DomainInterface*> components): values{std::move(components)} {
+	cardinality = 1;
+	for (const DomainInterface* domain : values) {
+		if (domain == nullptr) {
+			throw std::invalid_argument("the components can't be null");
+		}
+		if (domain->getNumberOfComponents() != 1) {
+			throw std::invalid_argument("the components must have one component each");
+		}
+
+		const SimpleDomain* simple{dynamic_cast<const SimpleDomain*>(domain)};
+		firsts.push_back(simple != nullptr ? simple->getFirst() : NOT_SIMPLE);
+		cardinalities.push_back(domain->getCardinality());
+		cardinality *= domain->getCardinality();
+	}
 
-	for (const auto& domain : values) {
-		card *= domain->getCardinality();
+	// Row-major, the last component changes the fastest
+	strides.resize(values.size());
+	int stride{1};
+	for (int i{static_cast<int>(values.size()) - 1}; i >= 0; --i) {
+		strides[i] = stride;
+		stride *= cardinalities[i];
 	}
+}
 
-	return card;
+int CompositeDomain::getCardinality() const {
+	return cardinality;
 }
 
 const DomainInterface* CompositeDomain::getComponent(int index) const {
@@ -31,6 +54,55 @@ int CompositeDomain::getNumberOfComponents() const {
 	return values.size();
 }
 
+int CompositeDomain::getStride(int component) const {
+	if (component < 0 || static_cast<std::size_t>(component) >= values.size()) {
+		throw std::out_of_range("the component must be one of the domain's components");
+	}
+
+	return strides[component];
+}
+
+int CompositeDomain::getComponentCardinality(int component) const {
+	if (component < 0 || static_cast<std::size_t>(component) >= values.size()) {
+		throw std::out_of_range("the component must be one of the domain's components");
+	}
+
+	return cardinalities[component];
+}
+
+int CompositeDomain::indexOfIndices(std::span<const int> indices) const {
+	if (indices.size() != values.size()) {
+		throw std::invalid_argument("there must be an index for every component");
+	}
+
+	int index{0};
+	for (std::size_t i{0}; i < indices.size(); ++i) {
+		if (indices[i] < 0 || indices[i] >= cardinalities[i]) {
+			throw std::out_of_range("the indices must be within the components' cardinalities");
+		}
+		index += indices[i] * strides[i];
+	}
+
+	return index;
+}
+
+void CompositeDomain::indicesForIndex(int index, std::span<int> indices) const {
+	if (index < 0) {
+		throw std::out_of_range("index must be greater than 0");
+	}
+	if (index >= cardinality) {
+		throw std::out_of_range("index must be less than the domain's cardinality");
+	}
+	if (indices.size() != values.size()) {
+		throw std::invalid_argument("there must be an index for every component");
+	}
+
+	for (std::size_t i{0}; i < indices.size(); ++i) {
+		indices[i] = index / strides[i];
+		index -= indices[i] * strides[i];
+	}
+}
+
 int CompositeDomain::indexOfElement(const DomainElement& e) const {
 	const int comp_n{getNumberOfComponents()};
 	if (e.getNumberOfComponents() != comp_n) {
@@ -39,14 +111,22 @@ int CompositeDomain::indexOfElement(const DomainElement& e) const {
 
 	int index{0};
 	for (int i{0}; i < comp_n; ++i) {
-		const DomainInterface* d{values[i]};
-
-		const int val_index{d->indexOfElement({e.getComponentValue(i)})};
-		if (val_index == DomainInterface::ELEMENT_NOT_PRESENT) {
-			return DomainInterface::ELEMENT_NOT_PRESENT;
+		const int value{e.getComponentValue(i)};
+
+		long long val_index;
+		if (firsts[i] != NOT_SIMPLE) {
+			val_index = value - firsts[i];
+			if (val_index < 0 || val_index >= cardinalities[i]) {
+				return DomainInterface::ELEMENT_NOT_PRESENT;
+			}
+		} else {
+			val_index = values[i]->indexOfElement({value});
+			if (val_index == DomainInterface::ELEMENT_NOT_PRESENT) {
+				return DomainInterface::ELEMENT_NOT_PRESENT;
+			}
 		}
 
-		index = index * d->getCardinality() + val_index;
+		index += static_cast<int>(val_index) * strides[i];
 	}
 
 	return index;
@@ -56,23 +136,28 @@ DomainElement CompositeDomain::elementForIndex(int index) const {
 	if (index < 0) {
 		throw std::out_of_range("index must be greater than 0");
 	}
-	if (index >= getCardinality()) {
+	if (index >= cardinality) {
 		throw std::out_of_range("index must be less than the domain's cardinality");
 	}
 
-	std::vector<int> result;
-	for (auto iter{values.crbegin()}; iter != values.crend(); ++iter) {
-		const DomainInterface* d{*iter};
-		const int card{d->getCardinality()};
+	const int comp_n{getNumberOfComponents()};
+
+	std::array<int, DomainElement::INLINE_CAPACITY> inline_result;
+	std::vector<int> heap_result;
+	int* result{inline_result.data()};
+	if (comp_n > DomainElement::INLINE_CAPACITY) {
+		heap_result.resize(comp_n);
+		result = heap_result.data();
+	}
 
-		const int val_index{index % card};
-		const int val{d->elementForIndex(val_index).getComponentValue(0)};
-		result.insert(result.begin(), val);
+	for (int i{0}; i < comp_n; ++i) {
+		const int val_index{index / strides[i]};
+		index -= val_index * strides[i];
 
-		index /= card;
+		result[i] = componentValueAt(i, val_index);
 	}
 
-	return DomainElement(result);
+	return DomainElement(result, comp_n);
 }
 
 bool CompositeDomain::operator==(const CompositeDomain& other) const {
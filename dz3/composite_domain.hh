@@ -4,11 +4,18 @@
 #include "simple_domain.hh"
 
 #include <initializer_list>
+#include <span>
 #include <vector>
 
+/**
+ * The cartesian product of any number of domains of one component each. The
+ * cardinalities and the strides of the components are computed at construction,
+ * so an element is mapped to its index and back without asking the components.
+ */
 class CompositeDomain : public DomainInterface {
 public:
 	CompositeDomain(std::initializer_list<DomainInterface*> l);
+	explicit CompositeDomain(std::vector<DomainInterface*> components);
 
 	int                    getCardinality() const override;
 	const DomainInterface* getComponent(int) const override;
@@ -16,8 +23,29 @@ public:
 	int                    indexOfElement(const DomainElement& e) const override;
 	DomainElement          elementForIndex(int) const override;
 
+	// The index of the component i within the element advances the element's index by getStride(i)
+	int getStride(int component) const;
+	int getComponentCardinality(int component) const;
+
+	// Maps the indices of an element within the components to the element's index, and back
+	int  indexOfIndices(std::span<const int> indices) const;
+	void indicesForIndex(int index, std::span<int> indices) const;
+	// The value of the component's element at the index
+	int  componentValueAt(int component, int index) const {
+		return firsts[component] != NOT_SIMPLE
+			? firsts[component] + index
+			: values[component]->elementForIndex(index).getComponentValue(0);
+	}
+
 	bool operator==(const CompositeDomain& other) const;
 	bool operator==(const DomainInterface& other) const override;
 private:
+	static constexpr long long NOT_SIMPLE{-1LL << 32};
+
 	std::vector<DomainInterface*> values;
+	std::vector<int>              cardinalities;
+	std::vector<int>              strides;
+	// The first value of every SimpleDomain component, whose value at i is first + i
+	std::vector<long long>        firsts;
+	int                           cardinality;
 };
@@ -1,5 +1,25 @@
 #include "constant_function.hh"
 
+#include <stdexcept>
+#include <algorithm>
+
 double ConstantFunction::valueAt(int) const {
 	return 1.0;
 }
+
+std::vector<Trapezoid> ConstantFunction::getTrapezoids() const {
+	return {{
+		Trapezoid::OPEN_LEFT,
+		Trapezoid::OPEN_LEFT,
+		Trapezoid::OPEN_RIGHT,
+		Trapezoid::OPEN_RIGHT
+	}};
+}
+
+void ConstantFunction::valuesAt(std::span<const int> in, std::span<double> out) const {
+	if (out.size() < in.size()) {
+		throw std::invalid_argument("the output must be at least as large as the input");
+	}
+
+	std::fill(out.begin(), out.begin() + in.size(), 1.0);
+}
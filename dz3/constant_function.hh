@@ -6,5 +6,7 @@ class ConstantFunction : public IntUnaryFunction {
 public:
 	ConstantFunction() = default;
 
-	double valueAt(int) const override;
+	double                 valueAt(int) const override;
+	void                   valuesAt(std::span<const int> in, std::span<double> out) const override;
+	std::vector<Trapezoid> getTrapezoids() const override;
 };
@@ -0,0 +1,169 @@
+#include "continuous_fuzzy_system.hh"
+
+#include "real_trapezoid_function.hh"
+#include "analytic_integration.hh"
+#include "floating_point.hh"
+
+#include <stdexcept>
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <cmath>
+
+ContinuousFuzzySystem::ContinuousFuzzySystem(
+	const std::vector<std::vector<std::array<RealUnaryFunction const*, 7>>>& outputs,
+	CompiledRuleBase::Implication i,
+	double f,
+	double l
+): implication{i}, first{f}, last{l} {
+	addRules(outputs);
+}
+
+ContinuousFuzzySystem::ContinuousFuzzySystem(
+	const std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>>& outputs,
+	CompiledRuleBase::Implication i,
+	double f,
+	double l
+): implication{i}, first{f}, last{l} {
+	// The extended terms only live until their trapezoids are copied
+	std::map<IntUnaryFunction const*, RealTrapezoidFunction> extended;
+	std::vector<std::vector<std::array<RealUnaryFunction const*, 7>>> real_outputs;
+	for (const auto& rules : outputs) {
+		auto& real_rules{real_outputs.emplace_back()};
+		for (const auto& rule : rules) {
+			auto& real_rule{real_rules.emplace_back()};
+			for (std::size_t k{0}; k < rule.size(); ++k) {
+				if (rule[k] == nullptr) {
+					throw std::invalid_argument("the rule contains a null function");
+				}
+
+				auto iter{extended.find(rule[k])};
+				if (iter == extended.end()) {
+					std::vector<RealTrapezoid> trapezoids;
+					for (const Trapezoid& t : rule[k]->getTrapezoids()) {
+						trapezoids.push_back(RealTrapezoid::fromTrapezoid(t));
+					}
+					iter = extended.emplace(rule[k], RealTrapezoidFunction(std::move(trapezoids))).first;
+				}
+				real_rule[k] = &iter->second;
+			}
+		}
+	}
+
+	addRules(real_outputs);
+}
+
+void ContinuousFuzzySystem::addRules(
+	const std::vector<std::vector<std::array<RealUnaryFunction const*, 7>>>& outputs
+) {
+	if (!(first < last)) {
+		throw std::domain_error("the first bound must be less than the last bound");
+	}
+
+	std::map<RealUnaryFunction const*, int> term_indices;
+	const auto termIndex{[&](RealUnaryFunction const* func) {
+		if (func == nullptr) {
+			throw std::invalid_argument("the rule contains a null function");
+		}
+
+		const auto iter{term_indices.find(func)};
+		if (iter != term_indices.end()) {
+			return iter->second;
+		}
+
+		terms.push_back(func->getTrapezoids());
+		const int index{static_cast<int>(terms.size()) - 1};
+		term_indices.emplace(func, index);
+		return index;
+	}};
+
+	const auto isConstantOne{[this](int term) {
+		const std::vector<RealTrapezoid>& pieces{terms[term]};
+		return pieces.size() == 1
+			&& pieces[0].b == RealTrapezoid::OPEN_LEFT
+			&& pieces[0].c == RealTrapezoid::OPEN_RIGHT;
+	}};
+
+	table.compile(outputs, termIndex, isConstantOne, [this](RealUnaryFunction const*, int term) {
+		consequent_term.push_back(term);
+	});
+
+	// A piece is non-zero within (a, d), or at a and d for a vertical ramp
+	table.buildActivationIndex([this](int term) {
+		RuleTable::Supports intervals;
+		for (const RealTrapezoid& t : terms[term]) {
+			intervals.emplace_back(t.a, std::nextafter(t.d, RealTrapezoid::OPEN_RIGHT));
+		}
+		return intervals;
+	});
+}
+
+int ContinuousFuzzySystem::getNumberOfOutputs() const {
+	return table.getNumberOfOutputs();
+}
+
+int ContinuousFuzzySystem::infer(
+	const double left,
+	const double right,
+	const double left_angled,
+	const double right_angled,
+	const double speed,
+	const double direction,
+	std::span<double> out
+) const {
+	if (out.size() < static_cast<std::size_t>(getNumberOfOutputs())) {
+		throw std::invalid_argument("the output must have room for every output variable");
+	}
+
+	const std::array<double, CompiledRuleBase::INPUTS> inputs{
+		left, right, left_angled, right_angled, speed, direction
+	};
+
+	// Scratch space is reused between the calls, so the steady state doesn't allocate
+	thread_local std::vector<double> strengths;
+	thread_local std::vector<AnalyticIntegration::Piece> pieces;
+	strengths.resize(consequent_term.size());
+
+	const int fired{table.fire(inputs, implication, [&](int antecedent) {
+		double max{0.0};
+		for (const RealTrapezoid& t : terms[table.getAntecedentTerm(antecedent)]) {
+			max = std::max(max, t.valueAt(inputs[table.getAntecedentInput(antecedent)]));
+		}
+		return max;
+	}, strengths.data())};
+
+	for (int output{0}; output < getNumberOfOutputs(); ++output) {
+		pieces.clear();
+		for (int c{table.getFirstConsequent(output)}; c < table.getFirstConsequent(output + 1); ++c) {
+			if (strengths[c] <= 0.0) {
+				continue;
+			}
+
+			for (const RealTrapezoid& t : terms[consequent_term[c]]) {
+				pieces.push_back({t, strengths[c]});
+			}
+		}
+
+		const AnalyticIntegration::Moments moments{
+			AnalyticIntegration::integrate(pieces, implication, first, last)
+		};
+		out[output] = FloatingPoint::isEqual(moments.area, 0) ? 0.0 : moments.moment / moments.area;
+	}
+
+	return fired;
+}
+
+double ContinuousFuzzySystem::infer(
+	const double left,
+	const double right,
+	const double left_angled,
+	const double right_angled,
+	const double speed,
+	const double direction
+) const {
+	thread_local std::vector<double> outputs;
+	outputs.resize(getNumberOfOutputs());
+
+	infer(left, right, left_angled, right_angled, speed, direction, outputs);
+	return outputs[0];
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "compiled_rule_base.hh"
+#include "rule_table.hh"
+#include "int_unary_function.hh"
+#include "real_unary_function.hh"
+#include "trapezoid.hh"
+
+#include <vector>
+#include <array>
+#include <span>
+
+/**
+ * Infers over a continuous output universe [first, last]. The inputs and the
+ * outputs are real, and the output set is integrated in closed form by
+ * AnalyticIntegration, so the resolution doesn't depend on a cardinality and
+ * the center of area isn't truncated. Rules over integer terms are inferred
+ * with the terms extended to the reals. The rules are compiled and fired by a
+ * RuleTable, like the ones of CompiledRuleBase.
+ */
+class ContinuousFuzzySystem {
+public:
+	// Every element of outputs holds the rules of one output
+	ContinuousFuzzySystem(
+		const std::vector<std::vector<std::array<RealUnaryFunction const*, 7>>>& outputs,
+		CompiledRuleBase::Implication implication,
+		double first,
+		double last
+	);
+	ContinuousFuzzySystem(
+		const std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>>& outputs,
+		CompiledRuleBase::Implication implication,
+		double first,
+		double last
+	);
+
+	int getNumberOfOutputs() const;
+
+	// Writes the output o to out[o], returns the number of rules that fired
+	int infer(
+		const double left,
+		const double right,
+		const double left_angled,
+		const double right_angled,
+		const double speed,
+		const double direction,
+		std::span<double> out
+	) const;
+
+	// The first output
+	double infer(
+		const double left,
+		const double right,
+		const double left_angled,
+		const double right_angled,
+		const double speed,
+		const double direction
+	) const;
+private:
+	void addRules(const std::vector<std::vector<std::array<RealUnaryFunction const*, 7>>>& outputs);
+
+	// Pieces of the term t are terms[t]
+	std::vector<std::vector<RealTrapezoid>> terms;
+	std::vector<int> consequent_term;
+
+	RuleTable table;
+
+	CompiledRuleBase::Implication implication;
+	double first;
+	double last;
+};
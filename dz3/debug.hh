@@ -3,6 +3,7 @@
 #include "domain_interface.hh"
 #include "fuzzy_set_interface.hh"
 #include "domain_element.hh"
+#include "domain_iterator.hh"
 
 #include <string>
 #include <iostream>
@@ -13,8 +14,8 @@ namespace Debug {
 			std::cout << desc << std::endl;
 		}
 
-		for (int i{0}; i < d->getCardinality(); ++i) {
-			std::cout << "Domain element: " << d->elementForIndex(i) << std::endl;
+		for (DomainIterator it(d); !it.isDone(); it.next()) {
+			std::cout << "Domain element: " << it.getElement() << std::endl;
 		}
 
 		std::cout << "Domain cardinality: " << d->getCardinality() << std::endl << std::endl;
@@ -24,10 +25,8 @@ namespace Debug {
 			std::cout << desc << std::endl;
 		}
 
-		const DomainInterface* d{f->getDomain()};
-		for (int i{0}; i < d->getCardinality(); ++i) {
-			const DomainElement& e{d->elementForIndex(i)};
-			std::cout << "d[" << e << "] = " << f->getValueAt(e) << std::endl;
+		for (DomainIterator it(f->getDomain()); !it.isDone(); it.next()) {
+			std::cout << "d[" << it.getElement() << "] = " << f->getValueAtIndex(it.getIndex()) << std::endl;
 		}
 	}
 };
@@ -0,0 +1,43 @@
+#include "defuzzifier_analytic_coa.hh"
+
+#include "defuzzifier_coa.hh"
+#include "aggregated_fuzzy_set.hh"
+#include "analytic_integration.hh"
+#include "floating_point.hh"
+
+#include <vector>
+
+int DefuzzifierAnalyticCOA::defuzzy(FuzzySetInterface* fs) const {
+	const AggregatedFuzzySet* set{dynamic_cast<const AggregatedFuzzySet*>(fs)};
+	if (set == nullptr || set->getLast() - set->getFirst() < 2) {
+		return DefuzzifierCOA().defuzzy(fs);
+	}
+
+	// Scratch space is reused between the calls, so the steady state doesn't allocate
+	thread_local std::vector<AnalyticIntegration::Piece> pieces;
+	pieces.clear();
+
+	for (int c{0}; c < set->getNumberOfConsequents(); ++c) {
+		const double strength{set->getStrength(c)};
+		if (strength <= 0.0) {
+			continue;
+		}
+
+		for (const Trapezoid& t : set->getTrapezoids(c)) {
+			pieces.push_back({RealTrapezoid::fromTrapezoid(t), strength});
+		}
+	}
+
+	const AnalyticIntegration::Moments moments{AnalyticIntegration::integrate(
+		pieces,
+		set->getImplication(),
+		set->getFirst(),
+		set->getLast() - 1
+	)};
+
+	if (FloatingPoint::isEqual(moments.area, 0)) {
+		return 0;
+	}
+
+	return moments.moment / moments.area;
+}
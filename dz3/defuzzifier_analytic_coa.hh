@@ -0,0 +1,14 @@
+#pragma once
+
+#include "defuzzifier.hh"
+
+/**
+ * Center of area computed in closed form from the consequents' breakpoints.
+ * The aggregated output of a rule base is integrated as a continuous function
+ * over [first, last - 1], so the cost doesn't depend on the universe's size.
+ * Other fuzzy sets are defuzzified by DefuzzifierCOA.
+ */
+class DefuzzifierAnalyticCOA : public Defuzzifier {
+public:
+	int defuzzy(FuzzySetInterface* fs) const override;
+};
@@ -0,0 +1,38 @@
+#include "defuzzifier_bisector.hh"
+
+#include "floating_point.hh"
+
+#include <vector>
+#include <numeric>
+#include <stdexcept>
+
+int DefuzzifierBisector::defuzzy(FuzzySetInterface* fs) const {
+	DomainInterface* d{fs->getDomain()};
+	if (d->getNumberOfComponents() != 1) {
+		throw std::invalid_argument("can't defuzzy the fuzzy set with more than one domain component");
+	}
+	if (d->getCardinality() == 0) {
+		throw std::invalid_argument("can't defuzzy the fuzzy set with no elements");
+	}
+
+	// Scratch space is reused between the calls, so the steady state doesn't allocate
+	thread_local std::vector<double> memberships;
+	memberships.resize(d->getCardinality());
+	fs->copyMemberships(memberships);
+
+	const double total{std::accumulate(memberships.begin(), memberships.end(), 0.0)};
+	if (FloatingPoint::isEqual(total, 0)) {
+		return 0;
+	}
+
+	double sum{0};
+	int i{0};
+	for (; i < d->getCardinality() - 1; ++i) {
+		sum += memberships[i];
+		if (sum >= total / 2) {
+			break;
+		}
+	}
+
+	return d->elementForIndex(i).getComponentValue(0);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "defuzzifier.hh"
+
+/**
+ * Bisector of area: the first element where the running sum of the
+ * memberships reaches half of their total, so that the area is split in two.
+ */
+class DefuzzifierBisector : public Defuzzifier {
+public:
+	int defuzzy(FuzzySetInterface* fs) const override;
+};
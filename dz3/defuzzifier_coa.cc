@@ -14,10 +14,10 @@ int DefuzzifierCOA::defuzzy(FuzzySetInterface* fs) const {
 	double sum_upper{0};
 	double sum_lower{0};
 	for (int i{0}; i < d->getCardinality(); ++i) {
-		const DomainElement& e{d->elementForIndex(i)};
+		const double mi{fs->getValueAtIndex(i)};
 
-		sum_upper += e.getComponentValue(0) * fs->getValueAt(e);
-		sum_lower += fs->getValueAt(e);
+		sum_upper += d->elementForIndex(i).getComponentValue(0) * mi;
+		sum_lower += mi;
 	}
 
 	if (FloatingPoint::isEqual(sum_lower, 0)) {
@@ -0,0 +1,28 @@
+#include "defuzzifier_height.hh"
+
+#include "defuzzifier_coa.hh"
+#include "aggregated_fuzzy_set.hh"
+#include "floating_point.hh"
+
+int DefuzzifierHeight::defuzzy(FuzzySetInterface* fs) const {
+	const AggregatedFuzzySet* set{dynamic_cast<const AggregatedFuzzySet*>(fs)};
+	if (set == nullptr) {
+		return DefuzzifierCOA().defuzzy(fs);
+	}
+
+	double sum_upper{0};
+	double sum_lower{0};
+	for (int c{0}; c < set->getNumberOfConsequents(); ++c) {
+		// A consequent that is zero over the universe adds nothing to the output set
+		const double strength{set->getHeight(c) > 0 ? set->getStrength(c) : 0.0};
+
+		sum_upper += set->getCentroid(c) * strength;
+		sum_lower += strength;
+	}
+
+	if (FloatingPoint::isEqual(sum_lower, 0)) {
+		return 0;
+	}
+
+	return sum_upper / sum_lower;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "defuzzifier.hh"
+
+/**
+ * Height method: the mean of the consequents' centroids weighted by their
+ * firing strengths. The centroids are computed once by the rule base, so the
+ * cost is one multiplication per consequent instead of a pass over the
+ * universe. Other fuzzy sets than the outputs of a rule base are defuzzified
+ * by DefuzzifierCOA.
+ */
+class DefuzzifierHeight : public Defuzzifier {
+public:
+	int defuzzy(FuzzySetInterface* fs) const override;
+};
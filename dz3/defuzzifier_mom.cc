@@ -0,0 +1,38 @@
+#include "defuzzifier_mom.hh"
+
+#include "floating_point.hh"
+
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+
+int DefuzzifierMOM::defuzzy(FuzzySetInterface* fs) const {
+	DomainInterface* d{fs->getDomain()};
+	if (d->getNumberOfComponents() != 1) {
+		throw std::invalid_argument("can't defuzzy the fuzzy set with more than one domain component");
+	}
+	if (d->getCardinality() == 0) {
+		throw std::invalid_argument("can't defuzzy the fuzzy set with no elements");
+	}
+
+	// Scratch space is reused between the calls, so the steady state doesn't allocate
+	thread_local std::vector<double> memberships;
+	memberships.resize(d->getCardinality());
+	fs->copyMemberships(memberships);
+
+	const double max{*std::max_element(memberships.begin(), memberships.end())};
+	if (FloatingPoint::isEqual(max, 0)) {
+		return 0;
+	}
+
+	double sum{0};
+	int count{0};
+	for (int i{0}; i < d->getCardinality(); ++i) {
+		if (FloatingPoint::isEqual(memberships[i], max)) {
+			sum += d->elementForIndex(i).getComponentValue(0);
+			++count;
+		}
+	}
+
+	return sum / count;
+}
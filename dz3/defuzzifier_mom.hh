@@ -0,0 +1,13 @@
+#pragma once
+
+#include "defuzzifier.hh"
+
+/**
+ * Mean of maxima: the mean of the elements where the membership is the
+ * largest. Ignores everything but the strongest consequents, so it follows
+ * the dominating rule instead of blending the rules.
+ */
+class DefuzzifierMOM : public Defuzzifier {
+public:
+	int defuzzy(FuzzySetInterface* fs) const override;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "defuzzifier.hh"
+
+/**
+ * Zero-order Takagi-Sugeno output: every consequent is reduced to a crisp
+ * value, its peak, and the output is the mean of the peaks weighted by the
+ * firing strengths. The peaks are computed once by the rule base. Other fuzzy
+ * sets than the outputs of a rule base are defuzzified by DefuzzifierCOA.
+ */
+class DefuzzifierSugeno : public Defuzzifier {
+public:
+	int defuzzy(FuzzySetInterface* fs) const override;
+};
@@ -3,6 +3,30 @@
 #include "simple_domain.hh"
 #include "composite_domain.hh"
 
+#include <stdexcept>
+#include <utility>
+
+static std::vector<DomainInterface*> componentsAt(DomainInterface* domain, std::span<const int> axes) {
+	if (domain == nullptr) {
+		throw std::invalid_argument("the domain can't be null");
+	}
+
+	const int n{domain->getNumberOfComponents()};
+	std::vector<DomainInterface*> components;
+	for (std::size_t k{0}; k < axes.size(); ++k) {
+		if (axes[k] < 0 || axes[k] >= n) {
+			throw std::out_of_range("the axes must be the domain's components");
+		}
+		if (k > 0 && axes[k] <= axes[k - 1]) {
+			throw std::invalid_argument("the axes must be strictly increasing");
+		}
+
+		components.push_back(const_cast<DomainInterface*>(domain->getComponent(axes[k])));
+	}
+
+	return components;
+}
+
 DomainInterface* DomainBuilder::intRange(int first, int last) {
 	return new SimpleDomain(first, last);
 }
@@ -10,3 +34,32 @@ DomainInterface* DomainBuilder::intRange(int first, int last) {
 DomainInterface* DomainBuilder::combine(DomainInterface* a, DomainInterface* b) {
 	return new CompositeDomain{a, b};
 }
+
+DomainInterface* DomainBuilder::combine(const std::vector<DomainInterface*>& components) {
+	return new CompositeDomain(components);
+}
+
+DomainInterface* DomainBuilder::project(DomainInterface* domain, std::span<const int> axes) {
+	return new CompositeDomain(componentsAt(domain, axes));
+}
+
+Handle<DomainInterface> DomainBuilder::intRange(Arena& arena, int first, int last) {
+	return arena.make<SimpleDomain>(first, last);
+}
+
+Handle<DomainInterface> DomainBuilder::combine(Arena& arena, Handle<DomainInterface> a, Handle<DomainInterface> b) {
+	return arena.make<CompositeDomain>(std::initializer_list<DomainInterface*>{a.get(), b.get()});
+}
+
+Handle<DomainInterface> DomainBuilder::combine(Arena& arena, const std::vector<Handle<DomainInterface>>& components) {
+	std::vector<DomainInterface*> domains;
+	for (const Handle<DomainInterface>& component : components) {
+		domains.push_back(component.get());
+	}
+
+	return arena.make<CompositeDomain>(std::move(domains));
+}
+
+Handle<DomainInterface> DomainBuilder::project(Arena& arena, Handle<DomainInterface> domain, std::span<const int> axes) {
+	return arena.make<CompositeDomain>(componentsAt(domain.get(), axes));
+}
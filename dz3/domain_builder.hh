@@ -2,9 +2,22 @@
 
 #include "domain_element.hh"
 #include "domain_interface.hh"
+#include "arena.hh"
+
+#include <vector>
+#include <span>
 
 class DomainBuilder {
 public:
 	static DomainInterface* intRange(int first, int last);
 	static DomainInterface* combine(DomainInterface* a, DomainInterface* b);
+	static DomainInterface* combine(const std::vector<DomainInterface*>& components);
+	// The domain of the components at the axes, which must be strictly increasing
+	static DomainInterface* project(DomainInterface* domain, std::span<const int> axes);
+
+	// The same, with the domains owned by the arena
+	static Handle<DomainInterface> intRange(Arena& arena, int first, int last);
+	static Handle<DomainInterface> combine(Arena& arena, Handle<DomainInterface> a, Handle<DomainInterface> b);
+	static Handle<DomainInterface> combine(Arena& arena, const std::vector<Handle<DomainInterface>>& components);
+	static Handle<DomainInterface> project(Arena& arena, Handle<DomainInterface> domain, std::span<const int> axes);
 };
@@ -2,34 +2,45 @@
 
 #include <string>
 #include <initializer_list>
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 
-DomainElement::DomainElement(std::initializer_list<int> l): values{l} {}
+DomainElement::DomainElement(std::initializer_list<int> l):
+	DomainElement(l.begin(), l.size()) {}
 
-DomainElement::DomainElement(const std::vector<int>& v): values{v} {}
+DomainElement::DomainElement(const std::vector<int>& v):
+	DomainElement(v.data(), v.size()) {}
 
-int DomainElement::getNumberOfComponents() const {
-	return values.size();
+DomainElement::DomainElement(const int* values, int n): size{n} {
+	if (size < 0) {
+		throw std::invalid_argument("the number of components must not be negative");
+	}
+
+	if (size <= INLINE_CAPACITY) {
+		std::copy(values, values + size, inline_values.begin());
+	} else {
+		heap_values.assign(values, values + size);
+	}
 }
 
 int DomainElement::getComponentValue(int index) const {
-	if (static_cast<std::size_t>(index) >= values.size()) {
+	if (index >= size) {
 		throw std::out_of_range("index is greater than the dimension");
 	}
 	if (index < 0) {
 		throw std::out_of_range("index is less than 0");
 	}
 
-	return values[index];
+	return data()[index];
 }
 
 std::string DomainElement::toString() const {
 	std::string result;
 
 	result += '(';
-	for (const auto& v : values) {
-		result += std::to_string(v) + ", ";
+	for (int i{0}; i < size; ++i) {
+		result += std::to_string(data()[i]) + ", ";
 	}
 	result.erase(result.end() - 2, result.end());
 	result += ')';
@@ -38,7 +49,7 @@ std::string DomainElement::toString() const {
 }
 
 bool operator==(const DomainElement& a, const DomainElement& b) {
-	return a.values == b.values;
+	return std::equal(a.data(), a.data() + a.size, b.data(), b.data() + b.size);
 }
 
 std::ostream& operator<<(std::ostream& out, const DomainElement& e) {
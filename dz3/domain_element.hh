@@ -2,22 +2,35 @@
 
 #include <string>
 #include <vector>
+#include <array>
 #include <initializer_list>
 #include <iostream>
 
 class DomainElement {
 public:
+	// Elements with at most this many components don't allocate
+	static constexpr int INLINE_CAPACITY{4};
+
 	DomainElement(std::initializer_list<int> l);
 	DomainElement(const std::vector<int>& v);
+	DomainElement(const int* values, int n);
 
-	int getNumberOfComponents() const;
+	int getNumberOfComponents() const {
+		return size;
+	}
 	int getComponentValue(int index) const;
 
 	std::string toString() const;
 
 	friend bool operator==(const DomainElement& a, const DomainElement& b);
 private:
-	std::vector<int> values;
+	const int* data() const {
+		return size <= INLINE_CAPACITY ? inline_values.data() : heap_values.data();
+	}
+
+	int                              size;
+	std::array<int, INLINE_CAPACITY> inline_values{};
+	std::vector<int>                 heap_values;
 };
 
 std::ostream& operator<<(std::ostream& out, const DomainElement& e);
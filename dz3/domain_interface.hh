@@ -2,6 +2,11 @@
 
 #include "domain_element.hh"
 
+/**
+ * Elements are indexed from 0 to getCardinality() - 1.
+ * Composite domains index their elements in row-major order: the last
+ * component changes the fastest.
+ */
 class DomainInterface {
 public:
 	virtual       int              getCardinality() const = 0;
@@ -0,0 +1,52 @@
+#include "domain_iterator.hh"
+
+#include <stdexcept>
+
+DomainIterator::DomainIterator(const DomainInterface* domain) {
+	if (domain == nullptr) {
+		throw std::invalid_argument("the domain can't be null");
+	}
+
+	composite = dynamic_cast<const CompositeDomain*>(domain);
+	if (composite == nullptr) {
+		// The product only reads its components
+		owned = std::make_unique<CompositeDomain>(std::vector<DomainInterface*>{const_cast<DomainInterface*>(domain)});
+		composite = owned.get();
+	}
+
+	const int n{composite->getNumberOfComponents()};
+	cardinality = composite->getCardinality();
+	indices.assign(n, 0);
+	values.resize(n);
+	if (!isDone()) {
+		for (int c{0}; c < n; ++c) {
+			values[c] = composite->componentValueAt(c, 0);
+		}
+	}
+}
+
+void DomainIterator::next() {
+	if (isDone()) {
+		throw std::out_of_range("the iterator is past the last element");
+	}
+
+	++index;
+	if (isDone()) {
+		return;
+	}
+
+	// The components before the first one that doesn't wrap around keep their values
+	for (int c{static_cast<int>(indices.size()) - 1}; c >= 0; --c) {
+		if (++indices[c] < composite->getComponentCardinality(c)) {
+			values[c] = composite->componentValueAt(c, indices[c]);
+			return;
+		}
+
+		indices[c] = 0;
+		values[c] = composite->componentValueAt(c, 0);
+	}
+}
+
+DomainElement DomainIterator::getElement() const {
+	return DomainElement(values.data(), values.size());
+}
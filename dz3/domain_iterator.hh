@@ -0,0 +1,49 @@
+#pragma once
+
+#include "domain_interface.hh"
+#include "domain_element.hh"
+#include "composite_domain.hh"
+
+#include <span>
+#include <vector>
+#include <memory>
+
+/**
+ * Walks the elements of a domain in the order of their indices. The indices of
+ * the element's components are kept as an odometer: a step advances the last
+ * component and carries into the previous ones, so the element is updated in
+ * place instead of being decoded from its index.
+ *
+ *	for (DomainIterator it(domain); !it.isDone(); it.next()) {
+ *		... it.getIndex(), it.getValues(), it.getElement()
+ *	}
+ */
+class DomainIterator {
+public:
+	explicit DomainIterator(const DomainInterface* domain);
+
+	bool isDone() const {
+		return index == cardinality;
+	}
+	void next();
+
+	int getIndex() const {
+		return index;
+	}
+	// The indices of the element's values within their components
+	std::span<const int> getIndices() const {
+		return indices;
+	}
+	std::span<const int> getValues() const {
+		return values;
+	}
+	DomainElement getElement() const;
+private:
+	// The product of the domain alone, when the domain isn't composite
+	std::unique_ptr<CompositeDomain> owned;
+	const CompositeDomain*           composite;
+	std::vector<int>                 indices;
+	std::vector<int>                 values;
+	int                              index{0};
+	int                              cardinality;
+};
@@ -0,0 +1,173 @@
+#include "fast_io.hh"
+
+#include <stdexcept>
+#include <system_error>
+#include <cstring>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+
+FastReader::FastReader(int f): fd{f}, buffer(CAPACITY) {
+	if (fd < 0) {
+		throw std::invalid_argument("the file descriptor must not be negative");
+	}
+}
+
+bool FastReader::fill() {
+	if (finished) {
+		return false;
+	}
+
+	// Move the partial line to the front, so there is room after it
+	if (begin > 0) {
+		std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+		end -= begin;
+		begin = 0;
+	}
+	if (end == buffer.size()) {
+		throw std::length_error("the line doesn't fit into the buffer");
+	}
+
+	while (true) {
+		const ssize_t count{read(fd, buffer.data() + end, buffer.size() - end)};
+		if (count > 0) {
+			end += count;
+			return true;
+		}
+		if (count == 0) {
+			finished = true;
+			return false;
+		}
+		if (errno != EINTR) {
+			throw std::system_error(errno, std::generic_category(), "can't read the input");
+		}
+	}
+}
+
+bool FastReader::hasBufferedLine() const {
+	return std::memchr(buffer.data() + begin, '\n', end - begin) != nullptr;
+}
+
+bool FastReader::nextInts(std::span<int> values) {
+	const char* p;
+	const char* line_end;
+	// Blank lines are skipped
+	while (true) {
+		const char* newline{nullptr};
+		while ((newline = static_cast<const char*>(std::memchr(buffer.data() + begin, '\n', end - begin))) == nullptr) {
+			if (!fill()) {
+				break;
+			}
+		}
+
+		p = buffer.data() + begin;
+		line_end = newline != nullptr ? newline : buffer.data() + end;
+		if (p == line_end && newline == nullptr) {
+			return false;
+		}
+		begin = line_end - buffer.data() + (newline != nullptr ? 1 : 0);
+
+		if (*p == 'K') {
+			return false;
+		}
+		if (!std::all_of(p, line_end, [](char c) { return c == ' ' || c == '\t' || c == '\r'; })) {
+			break;
+		}
+	}
+
+	for (int& value : values) {
+		while (p != line_end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+			++p;
+		}
+
+		const bool negative{p != line_end && *p == '-'};
+		if (negative || (p != line_end && *p == '+')) {
+			++p;
+		}
+		if (p == line_end || *p < '0' || *p > '9') {
+			throw std::invalid_argument("the line must contain the expected number of integers");
+		}
+
+		// Accumulated as a negative number, so INT_MIN doesn't overflow
+		long long result{0};
+		while (p != line_end && *p >= '0' && *p <= '9') {
+			result = result * 10 - (*p - '0');
+			if (result < INT_MIN) {
+				throw std::out_of_range("the integer doesn't fit into an int");
+			}
+			++p;
+		}
+		if (!negative && result == INT_MIN) {
+			throw std::out_of_range("the integer doesn't fit into an int");
+		}
+
+		value = negative ? result : -result;
+	}
+
+	return true;
+}
+
+FastWriter::FastWriter(int f): fd{f} {
+	if (fd < 0) {
+		throw std::invalid_argument("the file descriptor must not be negative");
+	}
+	buffer.reserve(CAPACITY);
+}
+
+FastWriter::~FastWriter() {
+	try {
+		flush();
+	} catch (...) {
+	}
+}
+
+void FastWriter::writeInt(int value) {
+	// Digits are produced backwards from the negated value, so INT_MIN doesn't overflow
+	char digits[12];
+	char* p{digits + sizeof(digits)};
+	const bool negative{value < 0};
+	int rest{negative ? value : -value};
+	do {
+		*--p = '0' - rest % 10;
+		rest /= 10;
+	} while (rest != 0);
+	if (negative) {
+		*--p = '-';
+	}
+
+	writeText({p, static_cast<std::size_t>(digits + sizeof(digits) - p)});
+}
+
+void FastWriter::writeChar(char c) {
+	if (buffer.size() == CAPACITY) {
+		flush();
+	}
+	buffer.push_back(c);
+}
+
+void FastWriter::writeText(std::string_view text) {
+	if (buffer.size() + text.size() > CAPACITY) {
+		flush();
+	}
+	buffer.insert(buffer.end(), text.begin(), text.end());
+}
+
+bool FastWriter::isEmpty() const {
+	return buffer.empty();
+}
+
+void FastWriter::flush() {
+	std::size_t written{0};
+	while (written < buffer.size()) {
+		const ssize_t count{write(fd, buffer.data() + written, buffer.size() - written)};
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw std::system_error(errno, std::generic_category(), "can't write the output");
+		}
+		written += count;
+	}
+	buffer.clear();
+}
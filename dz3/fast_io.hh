@@ -0,0 +1,54 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Reads lines of integers straight from a file descriptor, without stdio.
+ * Lines are parsed in place from a buffer that is refilled with whatever the
+ * peer has already sent, so several buffered lines are read with one call.
+ */
+class FastReader {
+public:
+	explicit FastReader(int fd);
+
+	// Parses the next line into values, false at the end of the input or at a line starting with K
+	bool nextInts(std::span<int> values);
+	// Whether a whole line is already buffered, so nextInts won't block
+	bool hasBufferedLine() const;
+private:
+	// Reads more of the input after the buffered data, false at the end of the input
+	bool fill();
+
+	static constexpr std::size_t CAPACITY{1 << 16};
+
+	int               fd;
+	std::vector<char> buffer;
+	std::size_t       begin{0};
+	std::size_t       end{0};
+	bool              finished{false};
+};
+
+// Formats into a buffer which is written to a file descriptor on flush
+class FastWriter {
+public:
+	explicit FastWriter(int fd);
+	~FastWriter();
+
+	FastWriter(const FastWriter&) = delete;
+	FastWriter& operator=(const FastWriter&) = delete;
+
+	void writeInt(int value);
+	void writeChar(char c);
+	void writeText(std::string_view text);
+
+	bool isEmpty() const;
+	void flush();
+private:
+	static constexpr std::size_t CAPACITY{1 << 16};
+
+	int               fd;
+	std::vector<char> buffer;
+};
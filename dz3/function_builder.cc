@@ -4,6 +4,11 @@
 #include "lambda_function.hh"
 #include "constant_function.hh"
 #include "combine_zadeh_or_function.hh"
+#include "real_trapezoid_function.hh"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 IntUnaryFunction const* FunctionBuilder::lFunction(int max, int min) {
 	return new LammaFunction(max, min, false);
@@ -27,3 +32,82 @@ IntUnaryFunction const* FunctionBuilder::combineZadehOr(
 ) {
 	return new CombineZadehOrFunction(a, b);
 }
+
+Handle<const IntUnaryFunction> FunctionBuilder::lFunction(Arena& arena, int max, int min) {
+	return arena.make<LammaFunction>(max, min, false);
+}
+
+Handle<const IntUnaryFunction> FunctionBuilder::gammaFunction(Arena& arena, int min, int max) {
+	return arena.make<LammaFunction>(min, max, true);
+}
+
+Handle<const IntUnaryFunction> FunctionBuilder::lambdaFunction(Arena& arena, int left, int mid, int right) {
+	return arena.make<LambdaFunction>(left, mid, right);
+}
+
+Handle<const IntUnaryFunction> FunctionBuilder::constantFunction(Arena& arena) {
+	return arena.make<ConstantFunction>();
+}
+
+Handle<const IntUnaryFunction> FunctionBuilder::combineZadehOr(
+	Arena& arena,
+	Handle<const IntUnaryFunction> a,
+	Handle<const IntUnaryFunction> b
+) {
+	return arena.make<CombineZadehOrFunction>(a.get(), b.get());
+}
+
+RealUnaryFunction const* FunctionBuilder::realLFunction(double max, double min) {
+	return new RealTrapezoidFunction({{RealTrapezoid::OPEN_LEFT, RealTrapezoid::OPEN_LEFT, max, min}});
+}
+
+RealUnaryFunction const* FunctionBuilder::realGammaFunction(double min, double max) {
+	return new RealTrapezoidFunction({{min, max, RealTrapezoid::OPEN_RIGHT, RealTrapezoid::OPEN_RIGHT}});
+}
+
+RealUnaryFunction const* FunctionBuilder::realLambdaFunction(double left, double mid, double right) {
+	// Like LambdaFunction, a lambda without a width is zero everywhere
+	if (left == right) {
+		return new RealTrapezoidFunction({});
+	}
+
+	return new RealTrapezoidFunction({{left, mid, mid, right}});
+}
+
+RealUnaryFunction const* FunctionBuilder::realConstantFunction() {
+	return new RealTrapezoidFunction({{
+		RealTrapezoid::OPEN_LEFT,
+		RealTrapezoid::OPEN_LEFT,
+		RealTrapezoid::OPEN_RIGHT,
+		RealTrapezoid::OPEN_RIGHT
+	}});
+}
+
+RealUnaryFunction const* FunctionBuilder::combineZadehOr(
+	RealUnaryFunction const* a,
+	RealUnaryFunction const* b
+) {
+	if (a == nullptr || b == nullptr) {
+		throw std::invalid_argument("the functions must not be null");
+	}
+
+	std::vector<RealTrapezoid> trapezoids{a->getTrapezoids()};
+	for (const RealTrapezoid& t : b->getTrapezoids()) {
+		trapezoids.push_back(t);
+	}
+
+	return new RealTrapezoidFunction(std::move(trapezoids));
+}
+
+RealUnaryFunction const* FunctionBuilder::realFunction(IntUnaryFunction const* f) {
+	if (f == nullptr) {
+		throw std::invalid_argument("the function must not be null");
+	}
+
+	std::vector<RealTrapezoid> trapezoids;
+	for (const Trapezoid& t : f->getTrapezoids()) {
+		trapezoids.push_back(RealTrapezoid::fromTrapezoid(t));
+	}
+
+	return new RealTrapezoidFunction(std::move(trapezoids));
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "int_unary_function.hh"
+#include "real_unary_function.hh"
+#include "static_functions.hh"
+#include "arena.hh"
 
 namespace FunctionBuilder {
 	IntUnaryFunction const* lFunction(int max, int min);
@@ -12,4 +15,36 @@ namespace FunctionBuilder {
 		IntUnaryFunction const* a,
 		IntUnaryFunction const* b
 	);
+
+	// The same functions owned by the arena
+	Handle<const IntUnaryFunction> lFunction(Arena& arena, int max, int min);
+	Handle<const IntUnaryFunction> gammaFunction(Arena& arena, int min, int max);
+	Handle<const IntUnaryFunction> lambdaFunction(Arena& arena, int left, int mid, int right);
+	Handle<const IntUnaryFunction> constantFunction(Arena& arena);
+
+	Handle<const IntUnaryFunction> combineZadehOr(
+		Arena& arena,
+		Handle<const IntUnaryFunction> a,
+		Handle<const IntUnaryFunction> b
+	);
+
+	// The same functions over the reals
+	RealUnaryFunction const* realLFunction(double max, double min);
+	RealUnaryFunction const* realGammaFunction(double min, double max);
+	RealUnaryFunction const* realLambdaFunction(double left, double mid, double right);
+	RealUnaryFunction const* realConstantFunction();
+
+	RealUnaryFunction const* combineZadehOr(
+		RealUnaryFunction const* a,
+		RealUnaryFunction const* b
+	);
+
+	// The function with the same trapezoids over the reals, equal to f at the integers up to rounding
+	RealUnaryFunction const* realFunction(IntUnaryFunction const* f);
+
+	// A composition of static functions, e.g. staticFunction<Static::Lambda<30, 60, 90>>()
+	template<Static::Trapezoidal F>
+	IntUnaryFunction const* staticFunction() {
+		return new Static::Function<F>();
+	}
 }
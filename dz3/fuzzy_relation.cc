@@ -0,0 +1,247 @@
+#include "fuzzy_relation.hh"
+
+#include "domain_builder.hh"
+#include "thread_pool.hh"
+
+#include <stdexcept>
+#include <algorithm>
+
+// The blocks of b and out touched by the innermost loops stay in the cache
+static constexpr int BLOCK_INNER{64};
+static constexpr int BLOCK_COLUMNS{512};
+static constexpr long long PARALLEL_THRESHOLD{1 << 22};
+
+static void checkBinary(DomainInterface* d) {
+	if (d == nullptr) {
+		throw std::invalid_argument("the domain must not be null");
+	}
+	if (d->getNumberOfComponents() != 2) {
+		throw std::invalid_argument("the relation isn't binary relation");
+	}
+	if (d->getComponent(0)->getNumberOfComponents() != 1) {
+		throw std::invalid_argument("the first component must have one component");
+	}
+	if (d->getComponent(1)->getNumberOfComponents() != 1) {
+		throw std::invalid_argument("the second component must have one component");
+	}
+}
+
+FuzzyRelation::FuzzyRelation(DomainInterface* x, DomainInterface* y) {
+	if (x == nullptr || y == nullptr) {
+		throw std::invalid_argument("the domains must not be null");
+	}
+
+	domain = DomainBuilder::combine(x, y);
+	checkBinary(domain);
+
+	rows = x->getCardinality();
+	columns = y->getCardinality();
+	memberships = std::vector(rows * columns, 0.0);
+}
+
+FuzzyRelation::FuzzyRelation(FuzzySetInterface* relation) {
+	if (relation == nullptr) {
+		throw std::invalid_argument("the relation must not be null");
+	}
+
+	domain = relation->getDomain();
+	checkBinary(domain);
+
+	rows = domain->getComponent(0)->getCardinality();
+	columns = domain->getComponent(1)->getCardinality();
+	memberships = std::vector(rows * columns, 0.0);
+	relation->copyMemberships(memberships);
+}
+
+DomainInterface* FuzzyRelation::getDomain() {
+	return domain;
+}
+
+double FuzzyRelation::getValueAt(const DomainElement& e) const {
+	const int index{domain->indexOfElement(e)};
+	if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
+		throw std::domain_error("the element must be inside of the set's core domain");
+	}
+
+	return memberships[index];
+}
+
+double FuzzyRelation::getValueAtIndex(int index) const {
+	return memberships.at(index);
+}
+
+void FuzzyRelation::copyMemberships(std::span<double> out) const {
+	if (out.size() != memberships.size()) {
+		throw std::invalid_argument("the output must have the domain's cardinality");
+	}
+
+	std::copy(memberships.begin(), memberships.end(), out.begin());
+}
+
+FuzzyRelation& FuzzyRelation::set(const DomainElement& e, double val) {
+	const int index{domain->indexOfElement(e)};
+	if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
+		throw std::domain_error("the element must be inside of the set's core domain");
+	}
+
+	memberships[index] = val;
+	alpha_cuts.reset();
+	return *this;
+}
+
+int FuzzyRelation::getRows() const {
+	return rows;
+}
+
+int FuzzyRelation::getColumns() const {
+	return columns;
+}
+
+MembershipWriter FuzzyRelation::write() {
+	return MembershipWriter(memberships, alpha_cuts);
+}
+
+std::span<const double> FuzzyRelation::getMemberships() const {
+	return memberships;
+}
+
+const AlphaCutIndex& FuzzyRelation::getAlphaCuts() const {
+	if (!alpha_cuts.has_value()) {
+		alpha_cuts.emplace(memberships);
+	}
+
+	return *alpha_cuts;
+}
+
+void FuzzyRelation::compose(
+	const FuzzyRelation& a,
+	const FuzzyRelation& b,
+	Composition composition,
+	FuzzyRelation& out
+) {
+	if (!(*a.domain->getComponent(1) == *b.domain->getComponent(0))) {
+		throw std::invalid_argument("the middle composition domains are not equal");
+	}
+	if (out.rows != a.rows || out.columns != b.columns) {
+		throw std::invalid_argument("the output relation has incompatible dimensions");
+	}
+	// The output is cleared before the operands are read
+	if (&out == &a || &out == &b) {
+		throw std::invalid_argument("the output relation must not be one of the operands");
+	}
+
+	out.alpha_cuts.reset();
+	composeMatrices(
+		a.memberships.data(),
+		b.memberships.data(),
+		out.memberships.data(),
+		a.rows,
+		a.columns,
+		b.columns,
+		composition
+	);
+}
+
+// out[j] = max(out[j], t(a, b[j])), written so that the compiler vectorizes it
+template<FuzzyRelation::Composition C>
+static void accumulateRow(double* __restrict out, const double* __restrict b, double a, int n) {
+	for (int j{0}; j < n; ++j) {
+		const double t{C == FuzzyRelation::Composition::MAX_MIN ? (b[j] < a ? b[j] : a) : a * b[j]};
+		out[j] = out[j] < t ? t : out[j];
+	}
+}
+
+// Computes the rows [first_row, last_row) of the composition
+template<FuzzyRelation::Composition C>
+static void composeBlocked(
+	const double* a,
+	const double* b,
+	double* out,
+	int first_row,
+	int last_row,
+	int inner,
+	int columns
+) {
+	std::fill(out + first_row * columns, out + last_row * columns, 0.0);
+
+	for (int jj{0}; jj < columns; jj += BLOCK_COLUMNS) {
+		const int j_n{std::min(BLOCK_COLUMNS, columns - jj)};
+
+		for (int kk{0}; kk < inner; kk += BLOCK_INNER) {
+			const int k_end{std::min(kk + BLOCK_INNER, inner)};
+
+			for (int i{first_row}; i < last_row; ++i) {
+				double* out_row{out + i * columns + jj};
+
+				for (int k{kk}; k < k_end; ++k) {
+					const double a_ik{a[i * inner + k]};
+
+					// Neither t-norm can exceed the initial zero
+					if (a_ik == 0.0) {
+						continue;
+					}
+
+					accumulateRow<C>(out_row, b + k * columns + jj, a_ik, j_n);
+				}
+			}
+		}
+	}
+}
+
+void FuzzyRelation::composeMatrices(
+	const double* a,
+	const double* b,
+	double* out,
+	int rows,
+	int inner,
+	int columns,
+	Composition composition
+) {
+	const auto composeRows{[&](int first_row, int last_row) {
+		if (composition == Composition::MAX_MIN) {
+			composeBlocked<Composition::MAX_MIN>(a, b, out, first_row, last_row, inner, columns);
+		} else {
+			composeBlocked<Composition::MAX_PRODUCT>(a, b, out, first_row, last_row, inner, columns);
+		}
+	}};
+
+	// Small compositions aren't worth waking the workers up
+	if (static_cast<long long>(rows) * inner * columns < PARALLEL_THRESHOLD) {
+		composeRows(0, rows);
+	} else {
+		ThreadPool::getDefault().parallelFor(rows, composeRows);
+	}
+}
+
+int FuzzyRelation::makeTransitive(std::span<double> scratch) {
+	if (rows != columns || !(*domain->getComponent(0) == *domain->getComponent(1))) {
+		throw std::invalid_argument("the relation isn't of U*U kind");
+	}
+	if (scratch.size() != memberships.size()) {
+		throw std::invalid_argument("the scratch must have the relation's cardinality");
+	}
+
+	alpha_cuts.reset();
+
+	// Every squaring doubles the length of the paths that are accounted for
+	int iterations{0};
+	bool changed{true};
+	while (changed) {
+		composeMatrices(
+			memberships.data(), memberships.data(), scratch.data(),
+			rows, rows, rows,
+			Composition::MAX_MIN
+		);
+		++iterations;
+
+		changed = false;
+		for (std::size_t i{0}; i < memberships.size(); ++i) {
+			if (scratch[i] > memberships[i]) {
+				memberships[i] = scratch[i];
+				changed = true;
+			}
+		}
+	}
+
+	return iterations;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "fuzzy_set_interface.hh"
+#include "domain_interface.hh"
+#include "domain_element.hh"
+#include "alpha_cut_index.hh"
+
+#include <vector>
+#include <span>
+#include <optional>
+
+/**
+ * A binary fuzzy relation over X x Y, stored as a dense row-major matrix:
+ * the membership of (x, y) is at row x and column y.
+ */
+class FuzzyRelation : public FuzzySetInterface {
+public:
+	enum class Composition {
+		MAX_MIN,
+		MAX_PRODUCT
+	};
+
+	FuzzyRelation(DomainInterface* x, DomainInterface* y);
+	// Copies any binary relation into the dense form
+	explicit FuzzyRelation(FuzzySetInterface* relation);
+
+	DomainInterface* getDomain() override;
+	double           getValueAt(const DomainElement&) const override;
+	double           getValueAtIndex(int index) const override;
+	void             copyMemberships(std::span<double> out) const override;
+
+	FuzzyRelation& set(const DomainElement& e, double val);
+
+	int getRows() const;
+	int getColumns() const;
+
+	double at(int row, int column) const {
+		return memberships[row * columns + column];
+	}
+	std::span<const double> getMemberships() const;
+	// Writes the memberships in place, the alpha-cut index is dropped when the writer goes out of scope
+	MembershipWriter        write();
+
+	// Indexed by row * columns + column, built on the first query after the memberships change,
+	// which isn't thread safe
+	const AlphaCutIndex& getAlphaCuts() const;
+
+	// Composes two relations, the output must be over the outer domains of a and b and be neither of them
+	static void compose(
+		const FuzzyRelation& a,
+		const FuzzyRelation& b,
+		Composition composition,
+		FuzzyRelation& out
+	);
+
+	/**
+	 * Replaces the relation with its max-min transitive closure, by squaring it
+	 * until nothing changes. The scratch must be as large as the relation.
+	 * Returns the number of squarings.
+	 */
+	int makeTransitive(std::span<double> scratch);
+
+	// Composes row-major matrices: out (rows x columns) = a (rows x inner) o b (inner x columns)
+	// and must not overlap a or b. Large compositions split their rows over ThreadPool::getDefault()
+	static void composeMatrices(
+		const double* a,
+		const double* b,
+		double* out,
+		int rows,
+		int inner,
+		int columns,
+		Composition composition
+	);
+private:
+	DomainInterface*    domain;
+	int                 rows;
+	int                 columns;
+	std::vector<double> memberships;
+	mutable std::optional<AlphaCutIndex> alpha_cuts;
+};
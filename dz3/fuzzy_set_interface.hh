@@ -3,10 +3,16 @@
 #include "domain_interface.hh"
 #include "domain_element.hh"
 
+#include <span>
+
 class FuzzySetInterface {
 public:
 	virtual DomainInterface* getDomain() = 0;
 	virtual double           getValueAt(const DomainElement&) const = 0;
 
+	// Index-addressed access, the indices are the ones of the set's domain
+	virtual double           getValueAtIndex(int) const = 0;
+	virtual void             copyMemberships(std::span<double> out) const = 0;
+
 	virtual ~FuzzySetInterface() {};
 };
@@ -1,7 +1,35 @@
 #pragma once
 
-class FuzzySystem {
+#include "profiled_system.hh"
+
+#include <span>
+#include <stdexcept>
+#include <cstddef>
+
+class FuzzySystem : public ProfiledSystem {
 public:
+	// Inputs of many tuples, the tuple i is made of the element i of every column
+	struct Columns {
+		std::span<const int> left;
+		std::span<const int> right;
+		std::span<const int> left_angled;
+		std::span<const int> right_angled;
+		std::span<const int> speed;
+		std::span<const int> direction;
+
+		// The number of tuples, throws if the columns differ in size
+		std::size_t size() const {
+			const std::size_t n{left.size()};
+			if (
+				right.size() != n || left_angled.size() != n || right_angled.size() != n
+				|| speed.size() != n || direction.size() != n
+			) {
+				throw std::invalid_argument("the input columns must be of the same size");
+			}
+			return n;
+		}
+	};
+
 	virtual int infer(
 		const int left,
 		const int right,
@@ -11,5 +39,24 @@ public:
 		const int direction
 	) const = 0;
 
+	// Infers every tuple into out, with the same results as infer
+	virtual void inferBatch(const Columns& inputs, std::span<int> out) const {
+		const std::size_t n{inputs.size()};
+		if (out.size() < n) {
+			throw std::invalid_argument("the output must be at least as large as the input");
+		}
+
+		for (std::size_t i{0}; i < n; ++i) {
+			out[i] = infer(
+				inputs.left[i],
+				inputs.right[i],
+				inputs.left_angled[i],
+				inputs.right_angled[i],
+				inputs.speed[i],
+				inputs.direction[i]
+			);
+		}
+	}
+
 	virtual ~FuzzySystem() {};
 };
@@ -2,12 +2,13 @@
 
 #include "fuzzy_system.hh"
 #include "defuzzifier.hh"
-#include "calculated_fuzzy_set.hh"
-#include "simple_domain.hh"
+#include "domain_interface.hh"
+#include "compiled_rule_base.hh"
 #include "int_unary_function.hh"
 
 #include <vector>
 #include <array>
+#include <memory>
 
 class FuzzySystemProduct : public FuzzySystem {
 public:
@@ -15,6 +16,12 @@ public:
 		const Defuzzifier* df,
 		std::vector<std::array<IntUnaryFunction const*, 7>> rules
 	);
+	// Fuzzifies the inputs within the ranges with lookup tables
+	FuzzySystemProduct(
+		const Defuzzifier* df,
+		std::vector<std::array<IntUnaryFunction const*, 7>> rules,
+		const std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS>& ranges
+	);
 
 	int infer(
 		const int left,
@@ -24,7 +31,10 @@ public:
 		const int speed,
 		const int direction
 	) const override;
+	void inferBatch(const Columns& inputs, std::span<int> out) const override;
+	int getNumberOfRules() const override;
 private:
-	const Defuzzifier* df;
-	std::vector<std::array<IntUnaryFunction const*, 7>> rules;
+	const Defuzzifier*               df;
+	std::unique_ptr<DomainInterface> domain;
+	CompiledRuleBase                 rules;
 };
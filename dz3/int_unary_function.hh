@@ -1,8 +1,31 @@
 #pragma once
 
+#include "trapezoid.hh"
+
+#include <vector>
+#include <span>
+#include <stdexcept>
+
 class IntUnaryFunction {
 public:
+	// Inputs are best passed to valuesAt in chunks of this size
+	static constexpr int BATCH_SIZE{256};
+
 	virtual double valueAt(int) const = 0;
 
+	// Evaluates the function for every input, out must be at least as large as in
+	virtual void valuesAt(std::span<const int> in, std::span<double> out) const {
+		if (out.size() < in.size()) {
+			throw std::invalid_argument("the output must be at least as large as the input");
+		}
+
+		for (std::size_t i{0}; i < in.size(); ++i) {
+			out[i] = valueAt(in[i]);
+		}
+	}
+
+	// Describes the function as a Zadeh union (max) of trapezoids
+	virtual std::vector<Trapezoid> getTrapezoids() const = 0;
+
 	virtual ~IntUnaryFunction() {};
 };
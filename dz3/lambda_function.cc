@@ -1,9 +1,11 @@
 #include "lambda_function.hh"
 
 #include <stdexcept>
+#include <algorithm>
 
 LambdaFunction::LambdaFunction(int l, int m, int r):
-	left{l}, mid{m}, right{r}, rise(left, mid, true), fall(mid, right, false) {
+	left{l}, mid{m}, right{r}, rise(left, mid, true), fall(mid, right, false),
+	rise_step{m == l ? 0.0 : 1.0 / (m - l)}, fall_step{r == m ? 0.0 : 1.0 / (r - m)} {
 	if (left > mid) {
 		throw std::invalid_argument("the left point must be smaller than or equal to the mid point");
 	}
@@ -18,4 +20,42 @@ double LambdaFunction::valueAt(int e) const {
 	}
 
 	return rise.valueAt(e) * fall.valueAt(e);
-}
\ No newline at end of file
+}
+
+std::vector<Trapezoid> LambdaFunction::getTrapezoids() const {
+	if (left == right) {
+		return {};
+	}
+
+	return {{left, mid, mid, right}};
+}
+
+void LambdaFunction::valuesAt(std::span<const int> in, std::span<double> out) const {
+	if (out.size() < in.size()) {
+		throw std::invalid_argument("the output must be at least as large as the input");
+	}
+
+	const std::size_t n{in.size()};
+	if (left == right) {
+		std::fill(out.begin(), out.begin() + n, 0.0);
+		return;
+	}
+
+	// The same product of the edges as valueAt, one edge per loop so that both vectorize
+	const int l{left};
+	const int m{mid};
+	const int r{right};
+	const double rs{rise_step};
+	const double fs{fall_step};
+	const int zero_from{m == r ? r + 1 : r};
+	for (std::size_t i{0}; i < n; ++i) {
+		const int x{in[i]};
+		const double ramp{std::max(0.0, (static_cast<double>(x) - l) * rs)};
+		out[i] = x >= m ? 1.0 : ramp;
+	}
+	for (std::size_t i{0}; i < n; ++i) {
+		const int x{in[i]};
+		const double ramp{std::min(1.0 - (static_cast<double>(x) - m) * fs, 1.0)};
+		out[i] *= x >= zero_from ? 0.0 : ramp;
+	}
+}
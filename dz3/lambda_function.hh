@@ -8,7 +8,9 @@ class LambdaFunction : public IntUnaryFunction {
 public:
 	LambdaFunction(int left, int mid, int right);
 
-	double valueAt(int) const override;
+	double                 valueAt(int) const override;
+	void                   valuesAt(std::span<const int> in, std::span<double> out) const override;
+	std::vector<Trapezoid> getTrapezoids() const override;
 private:
 	int left;
 	int mid;
@@ -16,4 +18,7 @@ private:
 
 	LammaFunction rise;
 	LammaFunction fall;
+
+	double rise_step;
+	double fall_step;
 };
@@ -1,17 +1,16 @@
 #include "lamma_function.hh"
 
 #include <stdexcept>
+#include <algorithm>
 
-LammaFunction::LammaFunction(int l, int r, bool rising): left{l}, right{r}, isRising{rising} {
+LammaFunction::LammaFunction(int l, int r, bool rising):
+	left{l}, right{r}, isRising{rising}, step{r == l ? 0.0 : 1.0 / (r - l)} {
 	if (left > right) {
 		throw std::invalid_argument("the left point must be greater than the right point");
 	}
 }
 
 double LammaFunction::valueAt(int val) const {
-	const int diff{right - left};
-	const double step{1.0 / diff};
-
 	if (isRising) {
 		if (val >= right) {
 			return 1.0;
@@ -32,3 +31,41 @@ double LammaFunction::valueAt(int val) const {
 		return 1.0 - (val - left) * step;
 	}
 }
+
+std::vector<Trapezoid> LammaFunction::getTrapezoids() const {
+	if (isRising) {
+		return {{left, right, Trapezoid::OPEN_RIGHT, Trapezoid::OPEN_RIGHT}};
+	}
+
+	return {{Trapezoid::OPEN_LEFT, Trapezoid::OPEN_LEFT, left, right}};
+}
+
+void LammaFunction::valuesAt(std::span<const int> in, std::span<double> out) const {
+	if (out.size() < in.size()) {
+		throw std::invalid_argument("the output must be at least as large as the input");
+	}
+
+	// Up to the end of the ramp a clamp gives the same values as valueAt, the end itself
+	// is selected because the ramp needn't reach exactly one there. Members are copied
+	// into locals and the clamp is computed unconditionally, otherwise the loops won't vectorize
+	const std::size_t n{in.size()};
+	const int l{left};
+	const int r{right};
+	const double s{step};
+
+	// A falling step without a ramp is still one at its point
+	const int zero_from{l == r ? r + 1 : r};
+	if (isRising) {
+		for (std::size_t i{0}; i < n; ++i) {
+			const int x{in[i]};
+			const double ramp{std::max(0.0, (static_cast<double>(x) - l) * s)};
+			out[i] = x >= r ? 1.0 : ramp;
+		}
+	} else {
+		for (std::size_t i{0}; i < n; ++i) {
+			const int x{in[i]};
+			const double ramp{std::min(1.0 - (static_cast<double>(x) - l) * s, 1.0)};
+			out[i] = x >= zero_from ? 0.0 : ramp;
+		}
+	}
+}
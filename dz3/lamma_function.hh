@@ -6,9 +6,12 @@ class LammaFunction : public IntUnaryFunction {
 public:
 	LammaFunction(int left, int right, bool isRising);
 
-	double valueAt(int) const override;
+	double                 valueAt(int) const override;
+	void                   valuesAt(std::span<const int> in, std::span<double> out) const override;
+	std::vector<Trapezoid> getTrapezoids() const override;
 private:
 	int left;
 	int right;
 	bool isRising;
+	double step;
 };
@@ -0,0 +1,59 @@
+#include "latency_histogram.hh"
+
+#include <bit>
+#include <stdexcept>
+#include <algorithm>
+
+void LatencyHistogram::record(std::uint64_t nanoseconds) {
+	const int bucket{std::min<int>(std::bit_width(nanoseconds), BUCKETS - 1)};
+	++buckets[bucket];
+	++count;
+	if (nanoseconds > max) {
+		max = nanoseconds;
+	}
+}
+
+std::uint64_t LatencyHistogram::getCount() const {
+	return count;
+}
+
+std::uint64_t LatencyHistogram::getMax() const {
+	return max;
+}
+
+std::uint64_t LatencyHistogram::getPercentile(double fraction) const {
+	if (fraction < 0.0 || fraction > 1.0) {
+		throw std::invalid_argument("the fraction must be between 0 and 1");
+	}
+	if (count == 0) {
+		return 0;
+	}
+
+	const std::uint64_t rank{static_cast<std::uint64_t>(fraction * (count - 1)) + 1};
+	std::uint64_t seen{0};
+	for (int b{0}; b < BUCKETS; ++b) {
+		seen += buckets[b];
+		if (seen >= rank) {
+			return b == 0 ? 0 : std::min(max, (std::uint64_t{1} << b) - 1);
+		}
+	}
+
+	return max;
+}
+
+void LatencyHistogram::print(std::ostream& out) const {
+	out << "ticks: " << count
+		<< ", p50: " << getPercentile(0.5) << " ns"
+		<< ", p99: " << getPercentile(0.99) << " ns"
+		<< ", p999: " << getPercentile(0.999) << " ns"
+		<< ", max: " << max << " ns\n";
+
+	for (int b{0}; b < BUCKETS; ++b) {
+		if (buckets[b] == 0) {
+			continue;
+		}
+
+		const std::uint64_t low{b == 0 ? 0 : std::uint64_t{1} << (b - 1)};
+		out << "\t[" << low << ", " << (b == 0 ? 1 : std::uint64_t{1} << b) << ") ns: " << buckets[b] << '\n';
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+// Counts latencies in power of two buckets of nanoseconds
+class LatencyHistogram {
+public:
+	static constexpr int BUCKETS{64};
+
+	void record(std::uint64_t nanoseconds);
+
+	std::uint64_t getCount() const;
+	std::uint64_t getMax() const;
+	// An upper bound of the latency below which the given fraction of the samples falls
+	std::uint64_t getPercentile(double fraction) const;
+
+	// Prints the percentiles and the non-empty buckets
+	void print(std::ostream& out) const;
+private:
+	// The bucket b counts the latencies in [2^(b - 1), 2^b), the bucket 0 the zeros
+	std::array<std::uint64_t, BUCKETS> buckets{};
+	std::uint64_t count{0};
+	std::uint64_t max{0};
+};
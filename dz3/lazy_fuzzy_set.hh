@@ -0,0 +1,261 @@
+#pragma once
+
+#include "fuzzy_set_interface.hh"
+#include "fuzzy_unary_function.hh"
+#include "fuzzy_binary_function.hh"
+#include "mutable_fuzzy_set.hh"
+#include "static_functions.hh"
+#include "arena.hh"
+
+#include <array>
+#include <span>
+#include <stdexcept>
+#include <concepts>
+#include <algorithm>
+
+/**
+ * Fuzzy set expressions that are evaluated lazily, e.g.
+ *	Lazy::combine(snorm, !Lazy::set(&a) | Lazy::set(&b), Lazy::set(&c))
+ * only records the tree of the operations. Materializing it evaluates every node
+ * in one pass over the domain, a block of elements at a time, and allocates the
+ * result only. The operands must have equal domains. Norms are either the
+ * functions of Operations, or the types of Static, which are inlined.
+ */
+namespace Lazy {
+	// The most elements evaluated at once, the temporaries of a block live on the stack
+	constexpr int BLOCK_SIZE{256};
+
+	template<typename E>
+	concept Expression = requires(const E& e, int index, double* out) {
+		{ e.getDomain() } -> std::same_as<DomainInterface*>;
+		{ e.valueAtIndex(index) } -> std::same_as<double>;
+		// Writes the elements [index, index + n), n <= BLOCK_SIZE
+		e.valuesAt(index, index, out);
+	};
+
+	// A set, whose memberships are read directly if it stores them
+	class Leaf {
+	public:
+		explicit Leaf(FuzzySetInterface* s): set{s} {
+			if (set == nullptr) {
+				throw std::invalid_argument("the fuzzy set can't be null");
+			}
+
+			const MutableFuzzySet* stored{dynamic_cast<const MutableFuzzySet*>(set)};
+			if (stored != nullptr) {
+				memberships = stored->getMemberships().data();
+			}
+		}
+
+		DomainInterface* getDomain() const {
+			return set->getDomain();
+		}
+
+		double valueAtIndex(int index) const {
+			return memberships != nullptr ? memberships[index] : set->getValueAtIndex(index);
+		}
+
+		void valuesAt(int first, int n, double* out) const {
+			if (memberships != nullptr) {
+				std::copy(memberships + first, memberships + first + n, out);
+				return;
+			}
+
+			for (int i{0}; i < n; ++i) {
+				out[i] = set->getValueAtIndex(first + i);
+			}
+		}
+	private:
+		FuzzySetInterface* set;
+		const double*      memberships{nullptr};
+	};
+
+	// Adapt the functions of Operations to the static interface of the norms
+	struct UnaryFunction {
+		const FuzzyUnaryFunction* f;
+
+		double valueAt(double v) const {
+			return f->valueAt(v);
+		}
+	};
+
+	struct BinaryFunction {
+		const FuzzyBinaryFunction* f;
+
+		double valueAt(double a, double b) const {
+			return f->valueAt(a, b);
+		}
+	};
+
+	template<typename F, Expression E>
+	class Unary {
+	public:
+		Unary(F f, E e): function{f}, operand{e} {
+		}
+
+		DomainInterface* getDomain() const {
+			return operand.getDomain();
+		}
+
+		double valueAtIndex(int index) const {
+			return function.valueAt(operand.valueAtIndex(index));
+		}
+
+		void valuesAt(int first, int n, double* out) const {
+			operand.valuesAt(first, n, out);
+			for (int i{0}; i < n; ++i) {
+				out[i] = function.valueAt(out[i]);
+			}
+		}
+	private:
+		F function;
+		E operand;
+	};
+
+	template<typename F, Expression L, Expression R>
+	class Binary {
+	public:
+		Binary(F f, L l, R r): function{f}, left{l}, right{r} {
+			DomainInterface* a{left.getDomain()};
+			DomainInterface* b{right.getDomain()};
+			if (a != b && !(*a == *b)) {
+				throw std::invalid_argument("the domains must be equal");
+			}
+		}
+
+		DomainInterface* getDomain() const {
+			return left.getDomain();
+		}
+
+		double valueAtIndex(int index) const {
+			return function.valueAt(left.valueAtIndex(index), right.valueAtIndex(index));
+		}
+
+		void valuesAt(int first, int n, double* out) const {
+			std::array<double, BLOCK_SIZE> values;
+			left.valuesAt(first, n, out);
+			right.valuesAt(first, n, values.data());
+			for (int i{0}; i < n; ++i) {
+				out[i] = function.valueAt(out[i], values[i]);
+			}
+		}
+	private:
+		F function;
+		L left;
+		R right;
+	};
+
+	inline Leaf set(FuzzySetInterface* s) {
+		return Leaf(s);
+	}
+
+	template<Expression E>
+	Unary<UnaryFunction, E> apply(const FuzzyUnaryFunction* f, E e) {
+		if (f == nullptr) {
+			throw std::invalid_argument("the function can't be null");
+		}
+		return {{f}, e};
+	}
+
+	// A static norm, e.g. apply<Static::ZadehNot>(e)
+	template<typename Norm, Expression E>
+	Unary<Norm, E> apply(E e) {
+		return {Norm{}, e};
+	}
+
+	template<Expression L, Expression R>
+	Binary<BinaryFunction, L, R> combine(const FuzzyBinaryFunction* f, L l, R r) {
+		if (f == nullptr) {
+			throw std::invalid_argument("the function can't be null");
+		}
+		return {{f}, l, r};
+	}
+
+	template<typename Norm, Expression L, Expression R>
+	Binary<Norm, L, R> combine(L l, R r) {
+		return {Norm{}, l, r};
+	}
+
+	// The Zadeh operations
+	template<Expression E>
+	auto operator!(E e) {
+		return apply<Static::ZadehNot>(e);
+	}
+
+	template<Expression L, Expression R>
+	auto operator&(L l, R r) {
+		return combine<Static::ZadehAnd>(l, r);
+	}
+
+	template<Expression L, Expression R>
+	auto operator|(L l, R r) {
+		return combine<Static::ZadehOr>(l, r);
+	}
+
+	// Evaluates the expression over its whole domain, in one pass
+	template<Expression E>
+	void evaluate(const E& e, std::span<double> out) {
+		const int card{e.getDomain()->getCardinality()};
+		if (out.size() != static_cast<std::size_t>(card)) {
+			throw std::invalid_argument("the output must have the domain's cardinality");
+		}
+
+		for (int first{0}; first < card; first += BLOCK_SIZE) {
+			e.valuesAt(first, std::min(BLOCK_SIZE, card - first), out.data() + first);
+		}
+	}
+
+	template<Expression E>
+	MutableFuzzySet* materialize(const E& e) {
+		MutableFuzzySet* result{new MutableFuzzySet(e.getDomain())};
+		evaluate(e, result->write().getMemberships());
+		return result;
+	}
+
+	template<Expression E>
+	Handle<MutableFuzzySet> materialize(Arena& arena, const E& e) {
+		Handle<MutableFuzzySet> result{arena.make<MutableFuzzySet>(e.getDomain(), arena.getResource())};
+		evaluate(e, result->write().getMemberships());
+		return result;
+	}
+
+	// The expression as a set, whose memberships are computed when they're queried
+	template<Expression E>
+	class Set : public FuzzySetInterface {
+	public:
+		explicit Set(E e): expression{e} {
+		}
+
+		DomainInterface* getDomain() override {
+			return expression.getDomain();
+		}
+
+		double getValueAt(const DomainElement& e) const override {
+			const int index{expression.getDomain()->indexOfElement(e)};
+			if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
+				throw std::domain_error("the element must be inside of the set's core domain");
+			}
+
+			return expression.valueAtIndex(index);
+		}
+
+		double getValueAtIndex(int index) const override {
+			if (index < 0 || index >= expression.getDomain()->getCardinality()) {
+				throw std::out_of_range("the index must be inside of the set's domain");
+			}
+
+			return expression.valueAtIndex(index);
+		}
+
+		void copyMemberships(std::span<double> out) const override {
+			evaluate(expression, out);
+		}
+	private:
+		E expression;
+	};
+
+	template<Expression E>
+	Set<E> view(E e) {
+		return Set<E>(e);
+	}
+}
@@ -3,45 +3,168 @@
 #include "fuzzy_system.hh"
 #include "fuzzy_system_min.hh"
 #include "fuzzy_system_product.hh"
+#include "multi_output_fuzzy_system.hh"
 #include "rules.hh"
+#include "fast_io.hh"
+#include "latency_histogram.hh"
+#include "rule_parser.hh"
+#include "profiler.hh"
 
-#include <cstdio> 
-#include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <array>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
 
-int main() {
+/**
+ * Reads a tuple of inputs per line and answers with a line of accel and omega,
+ * until a line starting with K. Flags:
+ *	--diagnostics	writes the outputs and the number of rules that fired to stderr, after the answer is sent
+ *	--pipelined		answers all of the ticks the peer has already sent at once
+ *	--histogram		prints a histogram of the per tick latency to stderr at the end
+ *	--rules FILE	loads the rules from FILE instead of the built in ones, see rule_parser.hh.
+ *					The compiled rules are cached in FILE.cache
+ *	--rules-version NAME	uses the rules NAME of the file instead of the last ones
+ *	--profile FILE	profiles the ticks, see profiler.hh, and appends the profile to FILE on SIGUSR1
+ *					and at the end. It's written as JSON if FILE ends with .json, as CSV otherwise
+ */
+int main(int argc, char* argv[]) {
+	bool diagnostics{false};
+	bool pipelined{false};
+	bool histogram{false};
+	std::string rules_path;
+	std::string rules_version;
+	std::string profile_path;
+	for (int i{1}; i < argc; ++i) {
+		const std::string_view flag{argv[i]};
+		if (flag == "--diagnostics") {
+			diagnostics = true;
+		} else if (flag == "--pipelined") {
+			pipelined = true;
+		} else if (flag == "--histogram") {
+			histogram = true;
+		} else if (flag == "--rules" && i + 1 < argc) {
+			rules_path = argv[++i];
+		} else if (flag == "--rules-version" && i + 1 < argc) {
+			rules_version = argv[++i];
+		} else if (flag == "--profile" && i + 1 < argc) {
+			profile_path = argv[++i];
+		} else {
+			std::cerr << "Usage: " << argv[0]
+				<< " [--diagnostics] [--pipelined] [--histogram] [--rules FILE] [--rules-version NAME] [--profile FILE]"
+				<< std::endl;
+			return 1;
+		}
+	}
 
 	Defuzzifier* def{new DefuzzifierCOA()};
-	FuzzySystem* fs_accel{new FuzzySystemProduct(def, Rules::get_for_accel())};
-	FuzzySystem* fs_omega{new FuzzySystemProduct(def, Rules::get_for_omega())};
-
-	while (true) {
-		char buff[1000];
-		fgets(buff, 1000, stdin);
-		if(buff[0] == 'K') {
-			break;
+	// Accel and omega share the fuzzification of the inputs
+	MultiOutputFuzzySystem* fs{nullptr};
+	if (rules_path.empty()) {
+		fs = new MultiOutputFuzzySystem(
+			def,
+			{Rules::get_for_accel(), Rules::get_for_omega()},
+			CompiledRuleBase::Implication::PRODUCT,
+			Rules::get_input_ranges()
+		);
+	} else {
+		RuleParser::Compiled loaded{RuleParser::load(rules_path, rules_version, rules_path + ".cache")};
+		if (loaded.rules.getNumberOfOutputs() != 2) {
+			throw std::invalid_argument("the rules must have two outputs, accel and omega");
 		}
+		loaded.rules.buildLookupTables(loaded.input_ranges);
+		fs = new MultiOutputFuzzySystem(def, std::move(loaded.rules), CompiledRuleBase::Implication::PRODUCT);
+	}
 
-		int left, right, left_angled, right_angled, speed, direction;
-		sscanf(
-			buff,
-			"%d %d %d %d %d %d",
-			&left,
-			&right,
-			&left_angled,
-			&right_angled,
-			&speed,
-			&direction
-		);
-		
-		const int accel{fs_accel->infer(left, right, left_angled, right_angled, speed, direction)};
-		std::cerr << "accel: " << accel << '\n';
-		const int omega{fs_omega->infer(left, right, left_angled, right_angled, speed, direction)};
-		std::cerr << "omega: " << omega << std::endl;
-		
-		fprintf(stdout, "%d %d\n", accel, omega);
-		fflush(stdout);
+	// Dumped by a thread of its own, so the control loop only records the ticks
+	Profiler* profiler{new Profiler(fs->getNumberOfRules())};
+	static std::mutex profile_file;
+	const Profiler::Format format{
+		profile_path.ends_with(".json") ? Profiler::Format::JSON : Profiler::Format::CSV
+	};
+	const auto dumpProfile{[profiler, profile_path, format]() {
+		std::lock_guard<std::mutex> lock(profile_file);
+		std::ofstream file(profile_path, std::ios::app);
+		profiler->dump(file, format);
+	}};
+	if (!profile_path.empty()) {
+		std::ofstream(profile_path, std::ios::trunc);
+
+		// SIGUSR1 is blocked here, so it's only received by the dumping thread
+		sigset_t signals;
+		sigemptyset(&signals);
+		sigaddset(&signals, SIGUSR1);
+		pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+		std::thread([signals, dumpProfile]() {
+			int signal;
+			while (sigwait(&signals, &signal) == 0) {
+				dumpProfile();
+			}
+		}).detach();
+
+		fs->setProfiler(profiler);
+		profiler->setEnabled(true);
+	}
+
+	FastReader input(STDIN_FILENO);
+	FastWriter output(STDOUT_FILENO);
+	FastWriter diagnostic(STDERR_FILENO);
+	LatencyHistogram latencies;
+
+	std::array<int, 6> in;
+	std::array<int, 2> outputs;
+	while (input.nextInts(in)) {
+		const auto start{std::chrono::steady_clock::now()};
+
+		const auto [left, right, left_angled, right_angled, speed, direction] = in;
+		const int fired{fs->infer(left, right, left_angled, right_angled, speed, direction, outputs)};
+
+		const int accel{outputs[0]};
+		const int omega{outputs[1]};
+		output.writeInt(accel);
+		output.writeChar(' ');
+		output.writeInt(omega);
+		output.writeChar('\n');
+
+		// The peer waits for the answer unless it has sent more ticks already
+		if (!pipelined || !input.hasBufferedLine()) {
+			output.flush();
+		}
+
+		if (histogram) {
+			const auto end{std::chrono::steady_clock::now()};
+			latencies.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		}
+
+		if (diagnostics) {
+			diagnostic.writeText("accel: ");
+			diagnostic.writeInt(accel);
+			diagnostic.writeText("\nomega: ");
+			diagnostic.writeInt(omega);
+			diagnostic.writeText("\nrules fired: ");
+			diagnostic.writeInt(fired);
+			diagnostic.writeChar('\n');
+			if (output.isEmpty()) {
+				diagnostic.flush();
+			}
+		}
+	}
+
+	output.flush();
+	diagnostic.flush();
+	if (!profile_path.empty()) {
+		dumpProfile();
+	}
+	if (histogram) {
+		latencies.print(std::cerr);
 	}
 
 	return 0;
@@ -0,0 +1,68 @@
+#include "multi_output_fuzzy_system.hh"
+
+#include "simple_domain.hh"
+
+#include <stdexcept>
+#include <utility>
+
+MultiOutputFuzzySystem::MultiOutputFuzzySystem(
+	const Defuzzifier* d,
+	std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>> outputs,
+	CompiledRuleBase::Implication i
+):
+	df(d), domain{std::make_unique<SimpleDomain>(-400, 400)}, rules(outputs, -400, 400), implication{i} {
+	if (df == nullptr) {
+		throw std::invalid_argument("the provided fuzzifier is null");
+	}
+}
+
+MultiOutputFuzzySystem::MultiOutputFuzzySystem(
+	const Defuzzifier* d,
+	std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>> outputs,
+	CompiledRuleBase::Implication i,
+	const std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS>& ranges
+): MultiOutputFuzzySystem(d, std::move(outputs), i) {
+	rules.buildLookupTables(ranges);
+}
+
+MultiOutputFuzzySystem::MultiOutputFuzzySystem(
+	const Defuzzifier* d,
+	CompiledRuleBase r,
+	CompiledRuleBase::Implication i
+):
+	df(d), domain{std::make_unique<SimpleDomain>(r.getFirst(), r.getLast())}, rules(std::move(r)), implication{i} {
+	if (df == nullptr) {
+		throw std::invalid_argument("the provided fuzzifier is null");
+	}
+}
+
+int MultiOutputFuzzySystem::getNumberOfOutputs() const {
+	return rules.getNumberOfOutputs();
+}
+
+int MultiOutputFuzzySystem::getNumberOfRules() const {
+	return rules.getNumberOfRules();
+}
+
+int MultiOutputFuzzySystem::infer(
+	const int left,
+	const int right,
+	const int left_angled,
+	const int right_angled,
+	const int speed,
+	const int direction,
+	std::span<int> out
+) const {
+	if (out.size() < static_cast<std::size_t>(getNumberOfOutputs())) {
+		throw std::invalid_argument("the output must have room for every output variable");
+	}
+
+	return inferOutputs(
+		rules,
+		implication,
+		df,
+		domain.get(),
+		{left, right, left_angled, right_angled, speed, direction},
+		out
+	);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "defuzzifier.hh"
+#include "domain_interface.hh"
+#include "compiled_rule_base.hh"
+#include "int_unary_function.hh"
+#include "profiled_system.hh"
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <span>
+
+/**
+ * Infers several output variables from the same inputs, e.g. accel and omega.
+ * Every distinct (term, input) antecedent is fuzzified once per inference and
+ * shared between the rule sets of all outputs. Every output is the same as the
+ * one of a FuzzySystemProduct or FuzzySystemMin over its rules alone.
+ */
+class MultiOutputFuzzySystem : public ProfiledSystem {
+public:
+	MultiOutputFuzzySystem(
+		const Defuzzifier* df,
+		std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>> outputs,
+		CompiledRuleBase::Implication implication
+	);
+	// Fuzzifies the inputs within the ranges with lookup tables
+	MultiOutputFuzzySystem(
+		const Defuzzifier* df,
+		std::vector<std::vector<std::array<IntUnaryFunction const*, 7>>> outputs,
+		CompiledRuleBase::Implication implication,
+		const std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS>& ranges
+	);
+
+	// Uses rules that are already compiled, e.g. loaded by RuleParser
+	MultiOutputFuzzySystem(
+		const Defuzzifier* df,
+		CompiledRuleBase rules,
+		CompiledRuleBase::Implication implication
+	);
+
+	int getNumberOfOutputs() const;
+	int getNumberOfRules() const override;
+
+	// Writes the output o to out[o], returns the number of rules that fired
+	int infer(
+		const int left,
+		const int right,
+		const int left_angled,
+		const int right_angled,
+		const int speed,
+		const int direction,
+		std::span<int> out
+	) const;
+private:
+	const Defuzzifier*               df;
+	std::unique_ptr<DomainInterface> domain;
+	CompiledRuleBase                 rules;
+	CompiledRuleBase::Implication    implication;
+};
@@ -1,15 +1,15 @@
 #include "mutable_fuzzy_set.hh"
 
 #include <stdexcept>
+#include <algorithm>
 
-MutableFuzzySet::MutableFuzzySet(DomainInterface* d):
-	domain{d} {
+MutableFuzzySet::MutableFuzzySet(DomainInterface* d, std::pmr::memory_resource* resource):
+	domain{d}, memberships(resource) {
 	if (domain == nullptr) {
 		throw std::invalid_argument("the domain must not be null");
 	}
 
-	const int card{domain->getCardinality()};
-	memberships = std::vector(card, 0.0);
+	memberships.assign(domain->getCardinality(), 0.0);
 }
 
 DomainInterface* MutableFuzzySet::getDomain() {
@@ -32,5 +32,40 @@ MutableFuzzySet& MutableFuzzySet::set(const DomainElement& e, double val) {
 	}
 
 	memberships[index] = val;
+	alpha_cuts.reset();
 	return *this;
 }
+
+double MutableFuzzySet::getValueAtIndex(int index) const {
+	return memberships.at(index);
+}
+
+void MutableFuzzySet::copyMemberships(std::span<double> out) const {
+	if (out.size() != memberships.size()) {
+		throw std::invalid_argument("the output must have the domain's cardinality");
+	}
+
+	std::copy(memberships.begin(), memberships.end(), out.begin());
+}
+
+MutableFuzzySet& MutableFuzzySet::setAtIndex(int index, double val) {
+	memberships.at(index) = val;
+	alpha_cuts.reset();
+	return *this;
+}
+
+MembershipWriter MutableFuzzySet::write() {
+	return MembershipWriter(memberships, alpha_cuts);
+}
+
+std::span<const double> MutableFuzzySet::getMemberships() const {
+	return memberships;
+}
+
+const AlphaCutIndex& MutableFuzzySet::getAlphaCuts() const {
+	if (!alpha_cuts.has_value()) {
+		alpha_cuts.emplace(memberships);
+	}
+
+	return *alpha_cuts;
+}
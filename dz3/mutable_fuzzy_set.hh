@@ -3,18 +3,36 @@
 #include "fuzzy_set_interface.hh"
 #include "domain_interface.hh"
 #include "domain_element.hh"
+#include "alpha_cut_index.hh"
 
 #include <vector>
+#include <memory_resource>
+#include <span>
+#include <optional>
 
 class MutableFuzzySet : public FuzzySetInterface {
 public:
-	MutableFuzzySet(DomainInterface* d);
+	// The memberships are allocated from the resource, e.g. Arena::getResource
+	MutableFuzzySet(
+		DomainInterface* d,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+	);
 
 	DomainInterface* getDomain() override;
 	double           getValueAt(const DomainElement&) const override;
+	double           getValueAtIndex(int index) const override;
+	void             copyMemberships(std::span<double> out) const override;
 
-	MutableFuzzySet& set(const DomainElement& e, double val);
+	MutableFuzzySet&  set(const DomainElement& e, double val);
+	MutableFuzzySet&  setAtIndex(int index, double val);
+	std::span<const double> getMemberships() const;
+	// Writes the memberships in place, the alpha-cut index is dropped when the writer goes out of scope
+	MembershipWriter        write();
+
+	// Built on the first query after the memberships change, which isn't thread safe
+	const AlphaCutIndex& getAlphaCuts() const;
 private:
 	DomainInterface*    domain;
-	std::vector<double> memberships;
+	std::pmr::vector<double> memberships;
+	mutable std::optional<AlphaCutIndex> alpha_cuts;
 };
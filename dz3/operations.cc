@@ -2,10 +2,17 @@
 
 #include "fuzzy_functions.hh"
 #include "mutable_fuzzy_set.hh"
+#include "sparse_fuzzy_set.hh"
+#include "domain_iterator.hh"
 
 #include <stdexcept>
+#include <span>
+#include <algorithm>
 
-FuzzySetInterface* Operations::unaryOperation(FuzzySetInterface* s, FuzzyUnaryFunction* f) {
+// The operations fill a set made by make, so that it can live on the heap or in an arena
+
+template<typename Make>
+static auto unary(FuzzySetInterface* s, FuzzyUnaryFunction* f, Make make) {
 	if (s == nullptr) {
 		throw std::invalid_argument("the fuzzy set can't be null");
 	}
@@ -15,19 +22,20 @@ FuzzySetInterface* Operations::unaryOperation(FuzzySetInterface* s, FuzzyUnaryFu
 
 	DomainInterface* d{s->getDomain()};
 
-	MutableFuzzySet* res = new MutableFuzzySet(d);
-	
-	for (int i{0}; i < d->getCardinality(); ++i) {
-		const DomainElement& e{d->elementForIndex(i)};
-		const double val{s->getValueAt(e)};
+	auto res{make(d)};
+	const MembershipWriter writer{res->write()};
+	const std::span<double> memberships{writer.getMemberships()};
 
-		res->set(e, f->valueAt(val));
+	s->copyMemberships(memberships);
+	for (double& val : memberships) {
+		val = f->valueAt(val);
 	}
 
 	return res;
 }
 
-FuzzySetInterface* Operations::binaryOperation(FuzzySetInterface* s1, FuzzySetInterface* s2, FuzzyBinaryFunction* f) {
+template<typename Make>
+static auto binary(FuzzySetInterface* s1, FuzzySetInterface* s2, FuzzyBinaryFunction* f, Make make) {
 	if (s1 == nullptr || s2 == nullptr) {
 		throw std::invalid_argument("the fuzzy set can't be null");
 	}
@@ -45,26 +53,127 @@ FuzzySetInterface* Operations::binaryOperation(FuzzySetInterface* s1, FuzzySetIn
 		throw std::invalid_argument("the domains must have the same number of components");
 	}
 
-	MutableFuzzySet* res = new MutableFuzzySet(d1);
+	auto res{make(d1)};
+	const MembershipWriter writer{res->write()};
+	const std::span<double> memberships{writer.getMemberships()};
+
+	// Equal domains index their elements the same way
+	if (d1 == d2 || *d1 == *d2) {
+		s1->copyMemberships(memberships);
+		for (std::size_t i{0}; i < memberships.size(); ++i) {
+			memberships[i] = f->valueAt(memberships[i], s2->getValueAtIndex(i));
+		}
+
+		return res;
+	}
 	
-	for (int i{0}; i < d1->getCardinality(); ++i) {
-		const DomainElement& e1{d1->elementForIndex(i)};
+	for (DomainIterator it(d1); !it.isDone(); it.next()) {
+		const int i{it.getIndex()};
 		
-		const int index{d2->indexOfElement(e1)};
+		const int index{d2->indexOfElement(it.getElement())};
 		if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
 			throw std::invalid_argument("the domains don't have the same elements");
 		}
-		const DomainElement& e2{d2->elementForIndex(index)};
-		
-		const double val1{s1->getValueAt(e1)};
-		const double val2{s2->getValueAt(e2)};
 
-		res->set(e1, f->valueAt(val1, val2));
+		const double val1{s1->getValueAtIndex(i)};
+		const double val2{s2->getValueAtIndex(index)};
+
+		memberships[i] = f->valueAt(val1, val2);
+	}
+
+	return res;
+}
+
+// Two sparse sets over the same domain, with a function that keeps the zeros zero
+static bool isMergeable(FuzzySetInterface* s1, FuzzySetInterface* s2, FuzzyBinaryFunction* f) {
+	if (dynamic_cast<SparseFuzzySet*>(s1) == nullptr || dynamic_cast<SparseFuzzySet*>(s2) == nullptr) {
+		return false;
+	}
+	if (f == nullptr) {
+		return false;
+	}
+
+	DomainInterface* d1{s1->getDomain()};
+	DomainInterface* d2{s2->getDomain()};
+
+	return (d1 == d2 || *d1 == *d2) && f->valueAt(0.0, 0.0) == 0.0;
+}
+
+// Merges the non-zeros of both sets. The result has no threshold, so it keeps every
+// membership the dense path keeps, whatever the thresholds of the operands
+template<typename Make>
+static auto merge(const SparseFuzzySet& s1, const SparseFuzzySet& s2, FuzzyBinaryFunction* f, Make make) {
+	auto res{make()};
+
+	const std::span<const int> i1{s1.getIndices()};
+	const std::span<const int> i2{s2.getIndices()};
+	const std::span<const double> m1{s1.getMemberships()};
+	const std::span<const double> m2{s2.getMemberships()};
+
+	std::size_t a{0};
+	std::size_t b{0};
+	while (a < i1.size() || b < i2.size()) {
+		if (b == i2.size() || (a < i1.size() && i1[a] < i2[b])) {
+			res->setAtIndex(i1[a], f->valueAt(m1[a], 0.0));
+			++a;
+		} else if (a == i1.size() || i2[b] < i1[a]) {
+			res->setAtIndex(i2[b], f->valueAt(0.0, m2[b]));
+			++b;
+		} else {
+			res->setAtIndex(i1[a], f->valueAt(m1[a], m2[b]));
+			++a;
+			++b;
+		}
 	}
 
 	return res;
 }
 
+FuzzySetInterface* Operations::unaryOperation(FuzzySetInterface* s, FuzzyUnaryFunction* f) {
+	return unary(s, f, [](DomainInterface* d) {
+		return new MutableFuzzySet(d);
+	});
+}
+
+FuzzySetInterface* Operations::binaryOperation(FuzzySetInterface* s1, FuzzySetInterface* s2, FuzzyBinaryFunction* f) {
+	if (isMergeable(s1, s2, f)) {
+		DomainInterface* d{s1->getDomain()};
+
+		return merge(*static_cast<SparseFuzzySet*>(s1), *static_cast<SparseFuzzySet*>(s2), f, [d]() {
+			return new SparseFuzzySet(d);
+		});
+	}
+
+	return binary(s1, s2, f, [](DomainInterface* d) {
+		return new MutableFuzzySet(d);
+	});
+}
+
+Handle<FuzzySetInterface> Operations::unaryOperation(Arena& arena, FuzzySetInterface* s, FuzzyUnaryFunction* f) {
+	return unary(s, f, [&arena](DomainInterface* d) {
+		return arena.make<MutableFuzzySet>(d, arena.getResource());
+	});
+}
+
+Handle<FuzzySetInterface> Operations::binaryOperation(
+	Arena& arena,
+	FuzzySetInterface* s1,
+	FuzzySetInterface* s2,
+	FuzzyBinaryFunction* f
+) {
+	if (isMergeable(s1, s2, f)) {
+		DomainInterface* d{s1->getDomain()};
+
+		return merge(*static_cast<SparseFuzzySet*>(s1), *static_cast<SparseFuzzySet*>(s2), f, [&arena, d]() {
+			return arena.make<SparseFuzzySet>(d, 0.0, arena.getResource());
+		});
+	}
+
+	return binary(s1, s2, f, [&arena](DomainInterface* d) {
+		return arena.make<MutableFuzzySet>(d, arena.getResource());
+	});
+}
+
 FuzzyUnaryFunction* Operations::zadehNot() {
 	return new ZadehNot();
 }
@@ -84,3 +193,23 @@ FuzzyBinaryFunction* Operations::hamacherTNorm(double v) {
 FuzzyBinaryFunction* Operations::hamacherSNorm(double v) {
 	return new HamacherSNorm(v);
 }
+
+Handle<FuzzyUnaryFunction> Operations::zadehNot(Arena& arena) {
+	return arena.make<ZadehNot>();
+}
+
+Handle<FuzzyBinaryFunction> Operations::zadehAnd(Arena& arena) {
+	return arena.make<ZadehAnd>();
+}
+
+Handle<FuzzyBinaryFunction> Operations::zadehOr(Arena& arena) {
+	return arena.make<ZadehOr>();
+}
+
+Handle<FuzzyBinaryFunction> Operations::hamacherTNorm(Arena& arena, double v) {
+	return arena.make<HamacherTNorm>(v);
+}
+
+Handle<FuzzyBinaryFunction> Operations::hamacherSNorm(Arena& arena, double v) {
+	return arena.make<HamacherSNorm>(v);
+}
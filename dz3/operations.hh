@@ -3,9 +3,13 @@
 #include "fuzzy_set_interface.hh"
 #include "fuzzy_unary_function.hh"
 #include "fuzzy_binary_function.hh"
+#include "arena.hh"
 
 namespace Operations {
 	FuzzySetInterface* unaryOperation(FuzzySetInterface* s, FuzzyUnaryFunction* f);
+	// Two SparseFuzzySets over the same domain are merged over their non-zeros into a SparseFuzzySet,
+	// when the function of two zeros is zero. The result has no threshold, so it has the same
+	// memberships as the result of the same sets stored densely
 	FuzzySetInterface* binaryOperation(FuzzySetInterface* s1, FuzzySetInterface* s2, FuzzyBinaryFunction* f);
 	
 	FuzzyUnaryFunction* zadehNot();
@@ -14,4 +18,20 @@ namespace Operations {
 
 	FuzzyBinaryFunction* hamacherTNorm(double v);
 	FuzzyBinaryFunction* hamacherSNorm(double v);
+
+	// The same, with the results owned by the arena
+	Handle<FuzzySetInterface> unaryOperation(Arena& arena, FuzzySetInterface* s, FuzzyUnaryFunction* f);
+	Handle<FuzzySetInterface> binaryOperation(
+		Arena& arena,
+		FuzzySetInterface* s1,
+		FuzzySetInterface* s2,
+		FuzzyBinaryFunction* f
+	);
+
+	Handle<FuzzyUnaryFunction> zadehNot(Arena& arena);
+	Handle<FuzzyBinaryFunction> zadehAnd(Arena& arena);
+	Handle<FuzzyBinaryFunction> zadehOr(Arena& arena);
+
+	Handle<FuzzyBinaryFunction> hamacherTNorm(Arena& arena, double v);
+	Handle<FuzzyBinaryFunction> hamacherSNorm(Arena& arena, double v);
 };
@@ -0,0 +1,56 @@
+#include "profiled_system.hh"
+
+#include "aggregated_fuzzy_set.hh"
+
+#include <stdexcept>
+#include <optional>
+#include <vector>
+
+void ProfiledSystem::setProfiler(Profiler* p) {
+	if (p != nullptr && p->getNumberOfRules() != getNumberOfRules()) {
+		throw std::invalid_argument("the profiler must have as many rules as the system");
+	}
+	profiler = p;
+}
+
+int ProfiledSystem::inferOutputs(
+	const CompiledRuleBase& rules,
+	CompiledRuleBase::Implication implication,
+	const Defuzzifier* df,
+	DomainInterface* domain,
+	const std::array<int, CompiledRuleBase::INPUTS>& inputs,
+	std::span<int> out
+) const {
+	thread_local std::vector<double> strengths;
+	strengths.resize(rules.getNumberOfConsequents());
+
+	// The tick is null unless the profiler is enabled
+	std::optional<Profiler::Tick> ticking;
+	if (profiler != nullptr && profiler->isEnabled()) {
+		ticking.emplace(*profiler);
+	}
+	Profiler::Tick* tick{ticking ? &*ticking : nullptr};
+
+	// One pass over the antecedents fires the rules of every output
+	const int fired{rules.fire(inputs, implication, strengths.data(), tick != nullptr ? tick->getRuleStrengths() : nullptr)};
+	if (tick != nullptr) {
+		tick->lap(Profiler::FUZZIFY);
+	}
+
+	for (int output{0}; output < rules.getNumberOfOutputs(); ++output) {
+		AggregatedFuzzySet result(domain, &rules, implication, strengths.data(), output);
+		if (tick != nullptr) {
+			tick->lap(Profiler::AGGREGATE);
+		}
+
+		out[output] = df->defuzzy(&result);
+		if (tick != nullptr) {
+			tick->lap(Profiler::DEFUZZIFY);
+		}
+	}
+
+	if (tick != nullptr) {
+		tick->finish(fired);
+	}
+	return fired;
+}
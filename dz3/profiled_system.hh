@@ -0,0 +1,45 @@
+#pragma once
+
+#include "profiler.hh"
+#include "compiled_rule_base.hh"
+#include "defuzzifier.hh"
+#include "domain_interface.hh"
+
+#include <array>
+#include <span>
+
+/**
+ * A system inferring from a compiled rule base, which records the ticks of its
+ * inference into a profiler while one is attached and enabled. Shared by the
+ * systems of one and of several outputs.
+ */
+class ProfiledSystem {
+public:
+	// The number of rules, which a profiler attached to the system must have as well
+	virtual int getNumberOfRules() const = 0;
+
+	/**
+	 * Records the ticks of infer into the profiler while it's enabled, null
+	 * detaches it. The profiler must be attached before inferring on other threads
+	 * and must outlive the system.
+	 */
+	void setProfiler(Profiler* p);
+
+	virtual ~ProfiledSystem() {};
+protected:
+	/**
+	 * Fires the rules for the inputs and defuzzifies the output o of the rule base
+	 * into out[o]. Returns the number of rules that fired. The phases are timed
+	 * only while the profiler is enabled, otherwise there is no tick at all.
+	 */
+	int inferOutputs(
+		const CompiledRuleBase& rules,
+		CompiledRuleBase::Implication implication,
+		const Defuzzifier* df,
+		DomainInterface* domain,
+		const std::array<int, CompiledRuleBase::INPUTS>& inputs,
+		std::span<int> out
+	) const;
+private:
+	Profiler* profiler{nullptr};
+};
@@ -0,0 +1,197 @@
+#include "profiler.hh"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+static std::atomic<std::uint64_t> next_id{0};
+static std::atomic<Profiler::AllocationCounter> allocation_counter{nullptr};
+
+static std::size_t countAllocations() {
+	const Profiler::AllocationCounter counter{allocation_counter.load(std::memory_order_relaxed)};
+	return counter == nullptr ? 0 : counter();
+}
+
+Profiler::Ring::Ring(int rules): fired(rules), strength(rules), rule_strengths(rules, 0.0) {}
+
+Profiler::Tick::Tick(Profiler& p):
+	profiler{p},
+	ring{p.getRing()},
+	last{std::chrono::steady_clock::now()},
+	allocations{countAllocations()} {}
+
+double* Profiler::Tick::getRuleStrengths() {
+	return ring.rule_strengths.data();
+}
+
+void Profiler::Tick::lap(Phase phase) {
+	const auto now{std::chrono::steady_clock::now()};
+	const auto elapsed{std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count()};
+	nanoseconds[phase] = static_cast<std::uint32_t>(std::min<long long>(
+		nanoseconds[phase] + elapsed,
+		std::numeric_limits<std::uint32_t>::max()
+	));
+	last = now;
+}
+
+void Profiler::Tick::finish(int fired) {
+	// Only this thread writes its counters, so they don't need atomic increments
+	for (int r{0}; r < profiler.rules; ++r) {
+		const double s{ring.rule_strengths[r]};
+		if (s > 0.0) {
+			ring.fired[r].store(ring.fired[r].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			ring.strength[r].store(ring.strength[r].load(std::memory_order_relaxed) + s, std::memory_order_relaxed);
+		}
+	}
+
+	const std::size_t allocated{countAllocations() - allocations};
+	profiler.record(ring, {
+		ring.ticks++,
+		nanoseconds,
+		static_cast<std::uint32_t>(std::min<std::size_t>(allocated, std::numeric_limits<std::uint32_t>::max())),
+		fired
+	});
+}
+
+Profiler::Profiler(int r): rules{r}, id{next_id.fetch_add(1, std::memory_order_relaxed)} {
+	if (rules < 0) {
+		throw std::invalid_argument("the number of rules must not be negative");
+	}
+}
+
+void Profiler::setAllocationCounter(AllocationCounter counter) {
+	allocation_counter.store(counter, std::memory_order_relaxed);
+}
+
+int Profiler::getNumberOfRules() const {
+	return rules;
+}
+
+void Profiler::setEnabled(bool e) {
+	enabled.store(e, std::memory_order_relaxed);
+}
+
+Profiler::Ring& Profiler::getRing() {
+	// The rings of the profilers this thread has recorded into, by the profiler's id.
+	// Ids aren't reused, so a destroyed profiler's entry is never looked up again
+	thread_local std::vector<std::pair<std::uint64_t, Ring*>> cache;
+	for (const auto& [cached_id, ring] : cache) {
+		if (cached_id == id) {
+			return *ring;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(registry);
+	rings.push_back(std::make_unique<Ring>(rules));
+	cache.emplace_back(id, rings.back().get());
+	return *rings.back();
+}
+
+void Profiler::record(Ring& ring, const Sample& s) {
+	const std::uint64_t head{ring.head.load(std::memory_order_relaxed)};
+	Slot& slot{ring.slots[head % CAPACITY]};
+
+	slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.words[0].store(s.tick, std::memory_order_relaxed);
+	slot.words[1].store(
+		std::uint64_t{s.nanoseconds[FUZZIFY]} << 32 | s.nanoseconds[AGGREGATE],
+		std::memory_order_relaxed
+	);
+	slot.words[2].store(std::uint64_t{s.nanoseconds[DEFUZZIFY]} << 32 | s.allocations, std::memory_order_relaxed);
+	slot.words[3].store(static_cast<std::uint32_t>(s.fired), std::memory_order_relaxed);
+	slot.sequence.store(2 * head + 2, std::memory_order_release);
+
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+bool Profiler::read(const Ring& ring, std::uint64_t n, Sample& s) {
+	const Slot& slot{ring.slots[n % CAPACITY]};
+
+	const std::uint64_t sequence{slot.sequence.load(std::memory_order_acquire)};
+	if (sequence != 2 * n + 2) {
+		return false;
+	}
+
+	const std::uint64_t fuzzify_aggregate{slot.words[1].load(std::memory_order_relaxed)};
+	const std::uint64_t defuzzify_allocations{slot.words[2].load(std::memory_order_relaxed)};
+	s.tick = slot.words[0].load(std::memory_order_relaxed);
+	s.nanoseconds[FUZZIFY] = static_cast<std::uint32_t>(fuzzify_aggregate >> 32);
+	s.nanoseconds[AGGREGATE] = static_cast<std::uint32_t>(fuzzify_aggregate);
+	s.nanoseconds[DEFUZZIFY] = static_cast<std::uint32_t>(defuzzify_allocations >> 32);
+	s.allocations = static_cast<std::uint32_t>(defuzzify_allocations);
+	s.fired = static_cast<int>(static_cast<std::uint32_t>(slot.words[3].load(std::memory_order_relaxed)));
+
+	// The thread may have started to overwrite the slot while it was read
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+void Profiler::dump(std::ostream& out, Format format) {
+	std::lock_guard<std::mutex> lock(registry);
+
+	const bool csv{format == Format::CSV};
+	out << (csv ? "thread,tick,fired,fuzzify_ns,aggregate_ns,defuzzify_ns,allocations\n" : "{\"samples\":[");
+
+	bool first{true};
+	std::uint64_t dropped{0};
+	for (std::size_t t{0}; t < rings.size(); ++t) {
+		Ring& ring{*rings[t]};
+		const std::uint64_t head{ring.head.load(std::memory_order_acquire)};
+
+		// Only the last CAPACITY samples are still in the ring
+		if (head - ring.tail > CAPACITY) {
+			ring.dropped += head - CAPACITY - ring.tail;
+			ring.tail = head - CAPACITY;
+		}
+
+		for (; ring.tail != head; ++ring.tail) {
+			Sample s;
+			if (!read(ring, ring.tail, s)) {
+				++ring.dropped;
+				continue;
+			}
+
+			if (csv) {
+				out << t << ',' << s.tick << ',' << s.fired << ','
+					<< s.nanoseconds[FUZZIFY] << ',' << s.nanoseconds[AGGREGATE] << ','
+					<< s.nanoseconds[DEFUZZIFY] << ',' << s.allocations << '\n';
+			} else {
+				out << (first ? "" : ",")
+					<< "{\"thread\":" << t << ",\"tick\":" << s.tick << ",\"fired\":" << s.fired
+					<< ",\"fuzzify_ns\":" << s.nanoseconds[FUZZIFY]
+					<< ",\"aggregate_ns\":" << s.nanoseconds[AGGREGATE]
+					<< ",\"defuzzify_ns\":" << s.nanoseconds[DEFUZZIFY]
+					<< ",\"allocations\":" << s.allocations << '}';
+			}
+			first = false;
+		}
+
+		dropped += ring.dropped;
+	}
+
+	out << (csv ? "\nrule,fired,mean_strength\n" : "],\"rules\":[");
+	for (int r{0}; r < rules; ++r) {
+		std::uint64_t fired{0};
+		double strength{0.0};
+		for (const std::unique_ptr<Ring>& ring : rings) {
+			fired += ring->fired[r].load(std::memory_order_relaxed);
+			strength += ring->strength[r].load(std::memory_order_relaxed);
+		}
+
+		const double mean{fired == 0 ? 0.0 : strength / fired};
+		if (csv) {
+			out << r << ',' << fired << ',' << mean << '\n';
+		} else {
+			out << (r == 0 ? "" : ",")
+				<< "{\"rule\":" << r << ",\"fired\":" << fired << ",\"mean_strength\":" << mean << '}';
+		}
+	}
+
+	if (csv) {
+		out << "\ndropped\n" << dropped << '\n';
+	} else {
+		out << "],\"dropped\":" << dropped << "}\n";
+	}
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+/**
+ * Records what a fuzzy system does on every tick: the strength of every rule,
+ * the time spent fuzzifying, aggregating and defuzzifying, and the allocations
+ * of the inferring thread. Only infer is recorded, not inferBatch. Every thread
+ * writes into a ring buffer of its own without locks or waiting, overwriting its
+ * oldest samples, and dump drains the rings from any thread. The systems a
+ * profiler is attached to only test a flag while it's disabled. The allocations
+ * are 0 unless an allocation counter is set, e.g. by the benchmarks.
+ */
+class Profiler {
+	struct Ring;
+public:
+	// The latest samples a thread keeps until they are dumped
+	static constexpr std::size_t CAPACITY{4096};
+
+	// Firing the rules, setting up the output sets and defuzzifying them. The sets are
+	// aggregated lazily, so the union of the consequents is part of DEFUZZIFY
+	enum Phase {
+		FUZZIFY,
+		AGGREGATE,
+		DEFUZZIFY,
+		PHASES
+	};
+
+	enum class Format {
+		CSV,
+		JSON
+	};
+
+	struct Sample {
+		// The tick's number within its thread
+		std::uint64_t tick;
+		std::array<std::uint32_t, PHASES> nanoseconds;
+		std::uint32_t allocations;
+		// The number of rules with a non-zero strength
+		int fired;
+	};
+
+	/**
+	 * Times the phases of one tick on the inferring thread and records it when
+	 * it's finished, e.g.
+	 *	Profiler::Tick tick(profiler);
+	 *	rules.fire(inputs, implication, strengths, tick.getRuleStrengths());
+	 *	tick.lap(Profiler::FUZZIFY);
+	 *	...
+	 *	tick.finish(fired);
+	 */
+	class Tick {
+	public:
+		explicit Tick(Profiler& profiler);
+
+		// Where the rule base writes the strength of every rule
+		double* getRuleStrengths();
+		// Adds the time since the last lap, or since the start, to the phase
+		void lap(Phase phase);
+		void finish(int fired);
+	private:
+		Profiler&                             profiler;
+		Ring&                                 ring;
+		std::chrono::steady_clock::time_point last;
+		std::size_t                           allocations;
+		std::array<std::uint32_t, PHASES>     nanoseconds{};
+	};
+
+	// Counts the allocations made by the calling thread, e.g. AllocCounter::getThreadAllocations
+	using AllocationCounter = std::size_t (*)();
+
+	explicit Profiler(int rules);
+
+	// Counts the allocations of all of the profilers' ticks, null to stop counting them
+	static void setAllocationCounter(AllocationCounter counter);
+
+	Profiler(const Profiler&) = delete;
+	Profiler& operator=(const Profiler&) = delete;
+
+	int getNumberOfRules() const;
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const {
+		return enabled.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Writes the samples recorded since the last dump, then the number of times
+	 * every rule fired and its mean strength when it did, and the number of
+	 * samples overwritten before they were dumped, since the start. A CSV dump has the header
+	 * thread,tick,fired,fuzzify_ns,aggregate_ns,defuzzify_ns,allocations, followed
+	 * by a blank line and rule,fired,mean_strength. A JSON dump is an object on a
+	 * single line, so that dumps can be appended to the same file.
+	 */
+	void dump(std::ostream& out, Format format);
+private:
+	/**
+	 * A sample packed into words, guarded by a sequence number that is odd while
+	 * the thread writes it, so that dump can tell a sample that was overwritten
+	 * while it read it. The sample n is complete when the sequence is 2n + 2.
+	 */
+	struct Slot {
+		std::atomic<std::uint64_t>                sequence{0};
+		std::array<std::atomic<std::uint64_t>, 4> words{};
+	};
+
+	// The samples of one thread, written by the thread and read by dump
+	struct Ring {
+		explicit Ring(int rules);
+
+		std::array<Slot, CAPACITY> slots;
+		// The next sample written by the thread
+		alignas(64) std::atomic<std::uint64_t> head{0};
+		// The next sample read by dump, and the ones it lost, only used while dumping
+		std::uint64_t tail{0};
+		std::uint64_t dropped{0};
+		// The number of ticks recorded by the thread
+		std::uint64_t ticks{0};
+
+		// Only the thread writes the counters, dump reads them
+		std::vector<std::atomic<std::uint64_t>> fired;
+		std::vector<std::atomic<double>>        strength;
+		std::vector<double>                     rule_strengths;
+	};
+
+	// The ring of the calling thread, registered on its first tick
+	Ring& getRing();
+	void record(Ring& ring, const Sample& sample);
+	// Reads the sample n of the ring, false if it was overwritten
+	static bool read(const Ring& ring, std::uint64_t n, Sample& sample);
+
+	const int           rules;
+	const std::uint64_t id;
+	std::atomic<bool>   enabled{false};
+
+	// Taken to register a thread and to dump, never on a tick
+	std::mutex                         registry;
+	std::vector<std::unique_ptr<Ring>> rings;
+};
@@ -0,0 +1,28 @@
+#include "real_trapezoid_function.hh"
+
+#include <stdexcept>
+#include <utility>
+
+RealTrapezoidFunction::RealTrapezoidFunction(std::vector<RealTrapezoid> t): trapezoids{std::move(t)} {
+	for (const RealTrapezoid& t : trapezoids) {
+		if (!(t.a <= t.b && t.b <= t.c && t.c <= t.d)) {
+			throw std::invalid_argument("the breakpoints of a trapezoid must be ordered");
+		}
+	}
+}
+
+double RealTrapezoidFunction::valueAt(double x) const {
+	double max{0.0};
+	for (const RealTrapezoid& t : trapezoids) {
+		const double val{t.valueAt(x)};
+		if (val > max) {
+			max = val;
+		}
+	}
+
+	return max;
+}
+
+std::vector<RealTrapezoid> RealTrapezoidFunction::getTrapezoids() const {
+	return trapezoids;
+}
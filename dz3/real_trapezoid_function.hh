@@ -0,0 +1,14 @@
+#pragma once
+
+#include "real_unary_function.hh"
+
+// The Zadeh union of trapezoids, no trapezoids make the function zero
+class RealTrapezoidFunction : public RealUnaryFunction {
+public:
+	RealTrapezoidFunction(std::vector<RealTrapezoid> trapezoids);
+
+	double                     valueAt(double) const override;
+	std::vector<RealTrapezoid> getTrapezoids() const override;
+private:
+	std::vector<RealTrapezoid> trapezoids;
+};
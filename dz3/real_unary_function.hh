@@ -0,0 +1,16 @@
+#pragma once
+
+#include "trapezoid.hh"
+
+#include <vector>
+
+// A membership function over the reals, the counterpart of IntUnaryFunction
+class RealUnaryFunction {
+public:
+	virtual double valueAt(double) const = 0;
+
+	// Describes the function as a Zadeh union (max) of trapezoids
+	virtual std::vector<RealTrapezoid> getTrapezoids() const = 0;
+
+	virtual ~RealUnaryFunction() {};
+};
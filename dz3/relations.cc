@@ -2,11 +2,38 @@
 
 #include "domain_interface.hh"
 #include "floating_point.hh"
-#include "domain_builder.hh"
+#include "fuzzy_relation.hh"
+#include "thread_pool.hh"
+#include "domain_iterator.hh"
 #include "mutable_fuzzy_set.hh"
+#include "tensor.hh"
 
 #include <stdexcept>
 #include <algorithm>
+#include <vector>
+#include <span>
+#include <optional>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <cmath>
+
+// The fused analysis works on groups of rows and on tiles of the relation, like the composition
+static constexpr int ANALYSIS_GROUP{32};
+static constexpr int ANALYSIS_BLOCK_INNER{64};
+static constexpr int ANALYSIS_BLOCK_COLUMNS{512};
+static constexpr long long ANALYSIS_PARALLEL_THRESHOLD{1 << 22};
+
+// Uses the relation directly when it's already dense, otherwise copies it into storage
+static const FuzzyRelation& dense(FuzzySetInterface* relation, std::optional<FuzzyRelation>& storage) {
+	const FuzzyRelation* r{dynamic_cast<const FuzzyRelation*>(relation)};
+	if (r != nullptr) {
+		return *r;
+	}
+
+	return storage.emplace(relation);
+}
 
 bool Relations::isUxU(FuzzySetInterface* relation) {
 	if (relation == nullptr) {
@@ -40,11 +67,11 @@ bool Relations::isReflexive(FuzzySetInterface* relation) {
 	DomainInterface* domain{relation->getDomain()};
 	const DomainInterface* u{domain->getComponent(0)};
 
-	for (int i{0}; i < u->getCardinality(); ++i) {
-		const DomainElement& e{u->elementForIndex(i)};
-		const int            e_int{e.getComponentValue(0)};
+	const int card{u->getCardinality()};
 
-		const double mi{relation->getValueAt({e_int, e_int})};
+	// The relation's elements are indexed row-major, (x, y) is at x * card + y
+	for (int i{0}; i < card; ++i) {
+		const double mi{relation->getValueAtIndex(i * card + i)};
 
 		if (!FloatingPoint::isEqual(mi, 1.0)) {
 			return false;
@@ -64,15 +91,9 @@ bool Relations::isSymmetric(FuzzySetInterface* relation) {
 	const int card{u->getCardinality()};
 
 	for (int i{0}; i < card - 1; ++i) {
-		const DomainElement& first{u->elementForIndex(i)};
-		const int            first_int{first.getComponentValue(0)};
-		
 		for (int j{i + 1}; j < card; ++j) {
-			const DomainElement& second{u->elementForIndex(j)};
-			const int            second_int{second.getComponentValue(0)};
-
-			const double mi_norm{relation->getValueAt({first_int, second_int})};
-			const double mi_inv {relation->getValueAt({second_int, first_int})};
+			const double mi_norm{relation->getValueAtIndex(i * card + j)};
+			const double mi_inv {relation->getValueAtIndex(j * card + i)};
 			
 			if (!FloatingPoint::isEqual(mi_norm, mi_inv)) {
 				return false;
@@ -92,45 +113,247 @@ bool Relations::isMaxMinTransitive(FuzzySetInterface* relation) {
 	const DomainInterface* u{domain->getComponent(0)};
 	const int card{u->getCardinality()};
 
-	for (int i{0}; i < card; ++i) {
-		const DomainElement& x{u->elementForIndex(i)};
-		const int            x_int{x.getComponentValue(0)};
+	std::optional<FuzzyRelation> copy;
+	const FuzzyRelation& r{dense(relation, copy)};
+	const std::span<const double> mi{r.getMemberships()};
 
-		for (int j{0}; j < card; ++j) {
-			const DomainElement& z{u->elementForIndex(j)};
-			const int            z_int{z.getComponentValue(0)};
+	// The relation is transitive when it contains its composition with itself
+	std::vector<double> squared(card * card);
+	FuzzyRelation::composeMatrices(
+		mi.data(), mi.data(), squared.data(),
+		card, card, card,
+		FuzzyRelation::Composition::MAX_MIN
+	);
+
+	for (int i{0}; i < card * card; ++i) {
+		if (mi[i] < squared[i]) {
+			return false;
+		}
+	}
 
-			double max{0.0};
+	return true;
+}
 
-			for (int k{0}; k < card; ++k) {
-				const DomainElement& y{u->elementForIndex(k)};
-				const int            y_int{y.getComponentValue(0)};
+bool Relations::isFuzzyEquivalence(FuzzySetInterface* relation) {
+	return analyze(relation, true).isFuzzyEquivalence();
+}
 
-				const double mi_xy{relation->getValueAt({x_int, y_int})};
-				const double mi_yz{relation->getValueAt({y_int, z_int})};
+// A property without a violation holds only if the analysis checked it to the end
+static bool holds(const std::optional<Relations::Violation>& violation, bool complete) {
+	if (violation.has_value()) {
+		return false;
+	}
+	if (!complete) {
+		throw std::logic_error("the analysis stopped at the first violation before checking the property");
+	}
+
+	return true;
+}
+
+bool Relations::Analysis::isReflexive() const {
+	return holds(reflexivity, complete);
+}
+
+bool Relations::Analysis::isSymmetric() const {
+	return holds(symmetry, complete);
+}
+
+bool Relations::Analysis::isMaxMinTransitive() const {
+	return holds(transitivity, complete);
+}
+
+bool Relations::Analysis::isFuzzyEquivalence() const {
+	// Any violation decides it, and without one every property was checked
+	return !reflexivity.has_value() && !symmetry.has_value() && !transitivity.has_value();
+}
+
+// Branchless FloatingPoint::isEqual, so that the loops using it vectorize
+static bool isEqual(double a, double b) {
+	const double diff{std::fabs(a - b)};
+
+	return (diff <= std::numeric_limits<double>::epsilon() * std::fabs(a + b) * FloatingPoint::PRECISION_DOUBLE)
+		| (diff < std::numeric_limits<double>::min());
+}
+
+// Counted in a double, so that the loop vectorizes without mixing vector widths
+static double countTransitivityViolations(
+	const double* __restrict row_x,
+	const double* __restrict row_y,
+	double mi_xy,
+	int n
+) {
+	double violations{0.0};
+	for (int z{0}; z < n; ++z) {
+		const double min{row_y[z] < mi_xy ? row_y[z] : mi_xy};
+		violations += row_x[z] < min ? 1.0 : 0.0;
+	}
+	return violations;
+}
 
-				const double min{std::min(mi_xy, mi_yz)};
+// Finds the first (y, z) for which the row x violates transitivity
+static std::optional<Relations::Violation> firstTransitivityViolation(const double* mi, int card, int x) {
+	const double* row_x{mi + x * card};
 
-				if (min > max) {
-					max = min;
+	for (int y{0}; y < card; ++y) {
+		const double mi_xy{row_x[y]};
+		const double* row_y{mi + y * card};
+
+		if (mi_xy == 0.0 || countTransitivityViolations(row_x, row_y, mi_xy, card) == 0.0) {
+			continue;
+		}
+
+		for (int z{0}; z < card; ++z) {
+			if (row_x[z] < std::min(mi_xy, row_y[z])) {
+				return Relations::Violation{x, y, z};
+			}
+		}
+	}
+
+	return std::nullopt;
+}
+
+Relations::Analysis Relations::analyze(FuzzySetInterface* relation, bool stop_at_first_violation) {
+	if (!Relations::isUxU(relation)) {
+		throw std::invalid_argument("the relation isn't of U*U kind");
+	}
+
+	std::optional<FuzzyRelation> copy;
+	const FuzzyRelation& r{dense(relation, copy)};
+	const double* mi{r.getMemberships().data()};
+	const int card{r.getRows()};
+
+	// The first row with a violation of each property, later rows don't need to check it anymore
+	constexpr int REFLEXIVITY{0};
+	constexpr int SYMMETRY{1};
+	constexpr int TRANSITIVITY{2};
+	std::array<std::atomic<int>, 3> first_row;
+	for (std::atomic<int>& row : first_row) {
+		row.store(card);
+	}
+
+	Analysis result;
+	std::mutex result_mutex;
+
+	const auto report{[&](int property, Violation v) {
+		std::lock_guard<std::mutex> lock(result_mutex);
+
+		std::optional<Violation>& current{
+			property == REFLEXIVITY ? result.reflexivity :
+			property == SYMMETRY ? result.symmetry :
+			result.transitivity
+		};
+		if (!current.has_value() || v.x < current->x) {
+			current = v;
+		}
+
+		int row{first_row[property].load()};
+		while (v.x < row && !first_row[property].compare_exchange_weak(row, v.x)) {}
+	}};
+
+	const auto needed{[&](int property, int x) {
+		if (stop_at_first_violation) {
+			return x < first_row[REFLEXIVITY].load(std::memory_order_relaxed)
+				&& x < first_row[SYMMETRY].load(std::memory_order_relaxed)
+				&& x < first_row[TRANSITIVITY].load(std::memory_order_relaxed);
+		}
+		return x < first_row[property].load(std::memory_order_relaxed);
+	}};
+
+	const auto analyzeGroup{[&](int first, int last) {
+		for (int x{first}; x < last; ++x) {
+			const double* row_x{mi + x * card};
+
+			if (needed(REFLEXIVITY, x) && !isEqual(row_x[x], 1.0)) {
+				report(REFLEXIVITY, {x, x, -1});
+			}
+
+			if (needed(SYMMETRY, x)) {
+				double violations{0.0};
+				for (int y{x + 1}; y < card; ++y) {
+					violations += isEqual(row_x[y], mi[y * card + x]) ? 0.0 : 1.0;
+				}
+
+				if (violations != 0.0) {
+					for (int y{x + 1}; y < card; ++y) {
+						if (!isEqual(row_x[y], mi[y * card + x])) {
+							report(SYMMETRY, {x, y, -1});
+							break;
+						}
+					}
 				}
 			}
+		}
 
-			const double mi_xz{relation->getValueAt({x_int, z_int})};
-			if (mi_xz < max) {
-				return false;
+		// Transitivity is checked in tiles, which the rows of the group share in the cache
+		std::array<double, ANALYSIS_GROUP> violations{};
+		int flagged{last};
+		bool complete{true};
+
+		for (int zz{0}; zz < card && complete; zz += ANALYSIS_BLOCK_COLUMNS) {
+			const int z_n{std::min(ANALYSIS_BLOCK_COLUMNS, card - zz)};
+
+			for (int yy{0}; yy < card; yy += ANALYSIS_BLOCK_INNER) {
+				const int y_end{std::min(yy + ANALYSIS_BLOCK_INNER, card)};
+
+				for (int x{first}; x < last; ++x) {
+					if (!needed(TRANSITIVITY, x)) {
+						continue;
+					}
+
+					const double* row_x{mi + x * card};
+					for (int y{yy}; y < y_end; ++y) {
+						if (row_x[y] != 0.0) {
+							violations[x - first] += countTransitivityViolations(
+								row_x + zz, mi + y * card + zz, row_x[y], z_n
+							);
+						}
+					}
+				}
+			}
+
+			for (int x{first}; x < last; ++x) {
+				if (violations[x - first] != 0.0) {
+					flagged = std::min(flagged, x);
+				}
+			}
+			complete = !(stop_at_first_violation && flagged < last);
+		}
+
+		// After an early stop the rows before the flagged one weren't checked completely
+		for (int x{complete ? flagged : first}; x <= flagged && x < last; ++x) {
+			if (!needed(TRANSITIVITY, x)) {
+				break;
+			}
+
+			const std::optional<Violation> v{firstTransitivityViolation(mi, card, x)};
+			if (v.has_value()) {
+				report(TRANSITIVITY, *v);
+				break;
 			}
 		}
+	}};
+
+	const int groups{(card + ANALYSIS_GROUP - 1) / ANALYSIS_GROUP};
+	const auto analyzeGroups{[&](int first, int last) {
+		for (int g{first}; g < last; ++g) {
+			analyzeGroup(g * ANALYSIS_GROUP, std::min((g + 1) * ANALYSIS_GROUP, card));
+		}
+	}};
+
+	if (static_cast<long long>(card) * card * card < ANALYSIS_PARALLEL_THRESHOLD) {
+		analyzeGroups(0, groups);
+	} else {
+		ThreadPool::getDefault().parallelFor(groups, analyzeGroups);
 	}
 
-	return true;
-}
+	// After a violation the other properties were only checked for the rows before it
+	result.complete = !stop_at_first_violation
+		|| !(result.reflexivity.has_value() || result.symmetry.has_value() || result.transitivity.has_value());
 
-bool Relations::isFuzzyEquivalence(FuzzySetInterface* relation) {
-	return isReflexive(relation) && isSymmetric(relation) && isMaxMinTransitive(relation);
+	return result;
 }
 
-FuzzySetInterface* Relations::compositionOfBinaryRelations(FuzzySetInterface* r1, FuzzySetInterface* r2) {
+static void checkComposable(FuzzySetInterface* r1, FuzzySetInterface* r2) {
 	if (r1 == nullptr) {
 		throw std::invalid_argument("the relation r1 is null");
 	}
@@ -186,42 +409,157 @@ FuzzySetInterface* Relations::compositionOfBinaryRelations(FuzzySetInterface* r1
 	if (!(*Y == *Y_other)) {
 		throw std::invalid_argument("the middle composition domains are not equal");
 	}
+}
 
-	DomainInterface* resultDomain{
-		DomainBuilder::combine(
-			const_cast<DomainInterface*>(X),
-			const_cast<DomainInterface*>(Z)
+static FuzzySetInterface* compose(
+	FuzzySetInterface* r1,
+	FuzzySetInterface* r2,
+	FuzzyRelation::Composition composition
+) {
+	std::optional<FuzzyRelation> copy1;
+	std::optional<FuzzyRelation> copy2;
+	const FuzzyRelation& a{dense(r1, copy1)};
+	const FuzzyRelation& b{dense(r2, copy2)};
+
+	FuzzyRelation* result{
+		new FuzzyRelation(
+			const_cast<DomainInterface*>(r1->getDomain()->getComponent(0)),
+			const_cast<DomainInterface*>(r2->getDomain()->getComponent(1))
 		)
 	};
-	MutableFuzzySet* result{new MutableFuzzySet(resultDomain)};
+	FuzzyRelation::compose(a, b, composition, *result);
 
-	for (int i{0}; i < X->getCardinality(); ++i) {
-		const DomainElement& x{X->elementForIndex(i)};
-		const int            x_int{x.getComponentValue(0)};
+	return result;
+}
 
-		for (int j{0}; j < Z->getCardinality(); ++j) {
-			const DomainElement& z{Z->elementForIndex(j)};
-			const int            z_int{z.getComponentValue(0)};
+FuzzySetInterface* Relations::compositionOfBinaryRelations(FuzzySetInterface* r1, FuzzySetInterface* r2) {
+	checkComposable(r1, r2);
 
-			double max{0.0};
+	return compose(r1, r2, FuzzyRelation::Composition::MAX_MIN);
+}
 
-			for (int k{0}; k < Y->getCardinality(); ++k) {
-				const DomainElement& y{Y->elementForIndex(k)};
-				const int            y_int{y.getComponentValue(0)};
+FuzzySetInterface* Relations::maxProductCompositionOfBinaryRelations(FuzzySetInterface* r1, FuzzySetInterface* r2) {
+	checkComposable(r1, r2);
 
-				const double mi_xy{r1->getValueAt({x_int, y_int})};
-				const double mi_yz{r2->getValueAt({y_int, z_int})};
+	return compose(r1, r2, FuzzyRelation::Composition::MAX_PRODUCT);
+}
 
-				const double min{std::min(mi_xy, mi_yz)};
+FuzzySetInterface* Relations::transitiveClosure(FuzzySetInterface* relation) {
+	if (!Relations::isUxU(relation)) {
+		throw std::invalid_argument("the relation isn't of U*U kind");
+	}
 
-				if (min > max) {
-					max = min;
-				}
+	FuzzyRelation* result{new FuzzyRelation(relation)};
+	std::vector<double> scratch(result->getMemberships().size());
+	result->makeTransitive(scratch);
+
+	return result;
+}
+
+std::vector<std::vector<DomainElement>> Relations::equivalenceClasses(FuzzySetInterface* relation, double alpha) {
+	if (!Relations::isUxU(relation)) {
+		throw std::invalid_argument("the relation isn't of U*U kind");
+	}
+
+	std::optional<FuzzyRelation> copy;
+	const FuzzyRelation& r{dense(relation, copy)};
+	const DomainInterface* u{relation->getDomain()->getComponent(0)};
+	const int card{u->getCardinality()};
+
+	std::vector<DomainElement> elements;
+	elements.reserve(card);
+	for (DomainIterator it(u); !it.isDone(); it.next()) {
+		elements.push_back(it.getElement());
+	}
+
+	std::vector<std::vector<DomainElement>> classes;
+	std::vector<bool> assigned(card, false);
+	for (int x{0}; x < card; ++x) {
+		if (assigned[x]) {
+			continue;
+		}
+
+		std::vector<DomainElement>& c{classes.emplace_back()};
+		for (int y{x}; y < card; ++y) {
+			if (!assigned[y] && r.at(x, y) >= alpha) {
+				assigned[y] = true;
+				c.push_back(elements[y]);
 			}
+		}
+	}
+
+	return classes;
+}
 
-			result->set({x_int, z_int}, max);
+// The memberships of a set, without a copy when they are already stored densely
+static std::span<const double> membershipsOf(FuzzySetInterface* set, std::vector<double>& storage) {
+	if (const FuzzyRelation* r{dynamic_cast<const FuzzyRelation*>(set)}; r != nullptr) {
+		return r->getMemberships();
+	}
+	if (const MutableFuzzySet* s{dynamic_cast<const MutableFuzzySet*>(set)}; s != nullptr) {
+		return s->getMemberships();
+	}
+
+	storage.resize(set->getDomain()->getCardinality());
+	set->copyMemberships(storage);
+	return storage;
+}
+
+// The shape of the larger domain, after checking that its components at the axes make up the smaller one
+static std::vector<int> shapeOf(DomainInterface* larger, DomainInterface* smaller, std::span<const int> axes) {
+	if (larger == nullptr || smaller == nullptr) {
+		throw std::invalid_argument("the domain is null");
+	}
+	if (static_cast<std::size_t>(smaller->getNumberOfComponents()) != axes.size()) {
+		throw std::invalid_argument("there must be an axis for every component of the smaller domain");
+	}
+
+	const int n{larger->getNumberOfComponents()};
+	for (std::size_t k{0}; k < axes.size(); ++k) {
+		if (axes[k] < 0 || axes[k] >= n) {
+			throw std::out_of_range("the axes must be components of the larger domain");
+		}
+		if (!(*larger->getComponent(axes[k]) == *smaller->getComponent(k))) {
+			throw std::invalid_argument("the components at the axes don't make up the smaller domain");
 		}
 	}
 
+	std::vector<int> shape(n);
+	for (int a{0}; a < n; ++a) {
+		shape[a] = larger->getComponent(a)->getCardinality();
+	}
+
+	return shape;
+}
+
+FuzzySetInterface* Relations::projection(FuzzySetInterface* relation, DomainInterface* onto, std::span<const int> axes) {
+	if (relation == nullptr) {
+		throw std::invalid_argument("the relation is null");
+	}
+
+	const std::vector<int> shape{shapeOf(relation->getDomain(), onto, axes)};
+
+	std::vector<double> storage;
+	const std::span<const double> mi{membershipsOf(relation, storage)};
+
+	MutableFuzzySet* result{new MutableFuzzySet(onto)};
+	Tensor::project(mi.data(), shape, axes, result->write().getMemberships().data());
+
+	return result;
+}
+
+FuzzySetInterface* Relations::cylindricalExtension(FuzzySetInterface* set, DomainInterface* onto, std::span<const int> axes) {
+	if (set == nullptr) {
+		throw std::invalid_argument("the set is null");
+	}
+
+	const std::vector<int> shape{shapeOf(onto, set->getDomain(), axes)};
+
+	std::vector<double> storage;
+	const std::span<const double> mi{membershipsOf(set, storage)};
+
+	MutableFuzzySet* result{new MutableFuzzySet(onto)};
+	Tensor::extend(mi.data(), shape, axes, result->write().getMemberships().data());
+
 	return result;
 }
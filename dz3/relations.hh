@@ -1,13 +1,63 @@
 #pragma once
 
 #include "fuzzy_set_interface.hh"
+#include "domain_element.hh"
+
+#include <vector>
+#include <optional>
+#include <span>
 
 namespace Relations {
+	// The elements are indices into U, the unused ones are -1
+	struct Violation {
+		int x;
+		int y;
+		int z;
+	};
+
+	/**
+	 * The first violation of each property, in the order of the rows of the
+	 * relation: reflexivity (x, x), symmetry (x, y) and max-min transitivity
+	 * (x, y, z) for mi(x, z) < min(mi(x, y), mi(y, z)).
+	 * An analysis that stopped at the first violation isn't complete: the
+	 * properties without a violation may not have been checked, so asking
+	 * whether they hold throws.
+	 */
+	struct Analysis {
+		std::optional<Violation> reflexivity;
+		std::optional<Violation> symmetry;
+		std::optional<Violation> transitivity;
+		bool                     complete{true};
+
+		bool isReflexive() const;
+		bool isSymmetric() const;
+		bool isMaxMinTransitive() const;
+		bool isFuzzyEquivalence() const;
+	};
+
 	bool isUxU(FuzzySetInterface* relation);
 	bool isReflexive(FuzzySetInterface* relation);
 	bool isSymmetric(FuzzySetInterface* relation);
 	bool isMaxMinTransitive(FuzzySetInterface* relation);
 	bool isFuzzyEquivalence(FuzzySetInterface* relation);
+
+	// Checks all three properties in one pass, optionally stopping at the first violation of any of them
+	Analysis analyze(FuzzySetInterface* relation, bool stop_at_first_violation);
 	
 	FuzzySetInterface* compositionOfBinaryRelations(FuzzySetInterface* r1, FuzzySetInterface* r2);
+	FuzzySetInterface* maxProductCompositionOfBinaryRelations(FuzzySetInterface* r1, FuzzySetInterface* r2);
+
+	FuzzySetInterface* transitiveClosure(FuzzySetInterface* relation);
+	// The classes of the alpha-cut, the relation must be a fuzzy equivalence
+	std::vector<std::vector<DomainElement>> equivalenceClasses(FuzzySetInterface* relation, double alpha);
+
+	/**
+	 * Projection and cylindrical extension of N-ary relations. The axes are the
+	 * strictly increasing components of the larger domain that make up the
+	 * smaller one, e.g. DomainBuilder::project(domain, axes).
+	 */
+	// The maximum over the relation's components that aren't among the axes
+	FuzzySetInterface* projection(FuzzySetInterface* relation, DomainInterface* onto, std::span<const int> axes);
+	// The set repeated along the domain's components that aren't among the axes
+	FuzzySetInterface* cylindricalExtension(FuzzySetInterface* set, DomainInterface* onto, std::span<const int> axes);
 };
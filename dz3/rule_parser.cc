@@ -0,0 +1,522 @@
+#include "rule_parser.hh"
+
+#include "function_builder.hh"
+#include "combine_zadeh_or_function.hh"
+
+#include <stdexcept>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <utility>
+
+namespace {
+	struct Variable {
+		std::vector<std::string> names;
+		// Inclusive bounds
+		int first;
+		int last;
+		std::map<std::string, IntUnaryFunction const*> terms;
+	};
+
+	// A condition of a rule, the input is one of the listed terms
+	struct Condition {
+		int column;
+		std::vector<std::string> terms;
+	};
+
+	struct RuleLine {
+		int line;
+		std::string text;
+	};
+
+	const std::array<std::string, CompiledRuleBase::INPUTS> INPUT_NAMES{"L", "R", "LA", "RA", "S", "D"};
+}
+
+static std::invalid_argument error(int line, const std::string& what) {
+	return std::invalid_argument("line " + std::to_string(line) + ": " + what);
+}
+
+static std::string trim(const std::string& s) {
+	const auto space{[](char c) { return c == ' ' || c == '\t' || c == '\r'; }};
+	const auto begin{std::find_if_not(s.begin(), s.end(), space)};
+	const auto end{std::find_if_not(s.rbegin(), std::string::const_reverse_iterator(begin), space).base()};
+	return std::string(begin, end);
+}
+
+static std::vector<std::string> split(const std::string& s, char separator) {
+	std::vector<std::string> parts;
+	std::stringstream stream(s);
+	std::string part;
+	while (std::getline(stream, part, separator)) {
+		parts.push_back(trim(part));
+	}
+	return parts;
+}
+
+static int parseInt(int line, const std::string& s) {
+	int value{0};
+	const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), value);
+	if (ec != std::errc() || end != s.data() + s.size()) {
+		throw error(line, "expected an integer instead of '" + s + "'");
+	}
+	return value;
+}
+
+static std::vector<int> parseInts(int line, const std::string& s, std::size_t count) {
+	std::vector<int> values;
+	for (const std::string& part : split(s, ',')) {
+		values.push_back(parseInt(line, part));
+	}
+	if (values.size() != count) {
+		throw error(line, "expected " + std::to_string(count) + " integers");
+	}
+	return values;
+}
+
+// \(a, b) falls, /(a, b) rises, A(a, b, c) is a triangle and a number v is the triangle around it
+static IntUnaryFunction const* parseTerm(Arena& arena, int line, const std::string& spec) {
+	static const std::regex shape{R"(^([\\/A])\((.*)\)$)"};
+
+	std::smatch match;
+	if (!std::regex_match(spec, match, shape)) {
+		const int v{parseInt(line, spec)};
+		return FunctionBuilder::lambdaFunction(arena, v - 1, v, v + 1).get();
+	}
+
+	try {
+		if (match[1] == "A") {
+			const std::vector<int> p{parseInts(line, match[2], 3)};
+			return FunctionBuilder::lambdaFunction(arena, p[0], p[1], p[2]).get();
+		}
+
+		const std::vector<int> p{parseInts(line, match[2], 2)};
+		if (match[1] == "\\") {
+			return FunctionBuilder::lFunction(arena, p[0], p[1]).get();
+		}
+		return FunctionBuilder::gammaFunction(arena, p[0], p[1]).get();
+	} catch (const std::invalid_argument& e) {
+		// The functions' own complaints don't know the line
+		const std::string what{e.what()};
+		if (what.rfind("line ", 0) == 0) {
+			throw;
+		}
+		throw error(line, what);
+	}
+}
+
+static std::vector<std::string> tokenize(const std::string& s) {
+	std::vector<std::string> tokens;
+	std::string token;
+	for (char c : s) {
+		if (c == '(' || c == ')' || c == ' ' || c == '\t' || c == '\r') {
+			if (!token.empty()) {
+				tokens.push_back(token);
+				token.clear();
+			}
+			if (c == '(' || c == ')') {
+				tokens.push_back(std::string(1, c));
+			}
+		} else {
+			token += c;
+		}
+	}
+	if (!token.empty()) {
+		tokens.push_back(token);
+	}
+	return tokens;
+}
+
+namespace {
+	// Parses the tokens of a single rule
+	class RuleReader {
+	public:
+		RuleReader(int l, const std::string& text): line{l}, tokens{tokenize(text)} {
+		}
+
+		void expect(const std::string& token) {
+			if (next() != token) {
+				throw error(line, "expected '" + token + "'");
+			}
+		}
+
+		bool accept(const std::string& token) {
+			if (position < tokens.size() && tokens[position] == token) {
+				++position;
+				return true;
+			}
+			return false;
+		}
+
+		std::string next() {
+			if (position == tokens.size()) {
+				throw error(line, "the rule ends too early");
+			}
+			return tokens[position++];
+		}
+
+		bool isFinished() const {
+			return position == tokens.size();
+		}
+
+		// ( NAME is TERMS ) or ( CONDITION or CONDITION ... ), where TERMS is NAME or ( NAME or NAME ... )
+		Condition condition() {
+			expect("(");
+			if (position < tokens.size() && tokens[position] == "(") {
+				Condition result{condition()};
+				while (accept("or")) {
+					const Condition other{condition()};
+					if (other.column != result.column) {
+						throw error(line, "only the terms of the same input can be joined with 'or'");
+					}
+					result.terms.insert(result.terms.end(), other.terms.begin(), other.terms.end());
+				}
+				expect(")");
+				return result;
+			}
+
+			const std::string input{next()};
+			const auto column{std::find(INPUT_NAMES.begin(), INPUT_NAMES.end(), input)};
+			if (column == INPUT_NAMES.end()) {
+				throw error(line, "unknown input '" + input + "'");
+			}
+			expect("is");
+
+			Condition result{static_cast<int>(column - INPUT_NAMES.begin()), {}};
+			if (accept("(")) {
+				result.terms.push_back(next());
+				while (accept("or")) {
+					result.terms.push_back(next());
+				}
+				expect(")");
+			} else {
+				result.terms.push_back(next());
+			}
+			expect(")");
+
+			return result;
+		}
+
+		const int line;
+	private:
+		std::vector<std::string> tokens;
+		std::size_t position{0};
+	};
+}
+
+RuleParser::Definition RuleParser::parse(std::istream& in, const std::string& version) {
+	static const std::regex variable_header{R"(^- (.+) \(([^()]+)\): ([\[{])(.*)([\]}])$)"};
+	static const std::regex term_line{R"(^- ([^:]+): (.+)$)"};
+	static const std::regex rules_header{R"(^Rules (.+):$)"};
+
+	enum class Section {
+		NONE,
+		INPUTS,
+		OUTPUTS,
+		RULES
+	};
+
+	// The terms are owned by the definition
+	Arena functions;
+	std::vector<Variable> inputs;
+	std::vector<Variable> outputs;
+	std::vector<std::string> versions;
+	std::map<std::string, std::vector<RuleLine>> rule_lines;
+
+	Section section{Section::NONE};
+	Variable* variable{nullptr};
+
+	std::string raw;
+	int line{0};
+	while (std::getline(in, raw)) {
+		++line;
+		const std::string text{trim(raw)};
+		std::smatch match;
+
+		if (text.empty()) {
+			continue;
+		}
+		if (text == "Input variables:") {
+			section = Section::INPUTS;
+			variable = nullptr;
+			continue;
+		}
+		if (text == "Output variables:") {
+			section = Section::OUTPUTS;
+			variable = nullptr;
+			continue;
+		}
+		if (std::regex_match(text, match, rules_header)) {
+			section = Section::RULES;
+			versions.push_back(match[1]);
+			if (rule_lines.count(versions.back()) != 0) {
+				throw error(line, "the rules " + versions.back() + " are defined twice");
+			}
+			rule_lines[versions.back()];
+			continue;
+		}
+
+		switch (section) {
+		case Section::NONE:
+			break;
+		case Section::INPUTS:
+		case Section::OUTPUTS:
+			if (std::regex_match(text, match, variable_header)) {
+				const bool is_set{match[3] == "{"};
+				if (is_set != (match[5] == "}")) {
+					throw error(line, "mismatched brackets of the range");
+				}
+
+				std::vector<int> bounds;
+				for (const std::string& part : split(match[4], ',')) {
+					bounds.push_back(parseInt(line, part));
+				}
+				if (!is_set && bounds.size() != 2) {
+					throw error(line, "a range must have two bounds");
+				}
+				if (bounds.empty()) {
+					throw error(line, "a set must not be empty");
+				}
+
+				std::vector<Variable>& variables{section == Section::INPUTS ? inputs : outputs};
+				variables.push_back({
+					split(match[2], ','),
+					*std::min_element(bounds.begin(), bounds.end()),
+					*std::max_element(bounds.begin(), bounds.end()),
+					{}
+				});
+				if (!is_set && bounds[0] > bounds[1]) {
+					throw error(line, "the first bound must not be greater than the last bound");
+				}
+				variable = &variables.back();
+			} else if (std::regex_match(text, match, term_line)) {
+				if (variable == nullptr) {
+					throw error(line, "a term must follow a variable");
+				}
+				if (!variable->terms.emplace(trim(match[1]), parseTerm(functions, line, trim(match[2]))).second) {
+					throw error(line, "the term " + trim(match[1]) + " is defined twice");
+				}
+			} else {
+				throw error(line, "expected a variable or a term");
+			}
+			break;
+		case Section::RULES:
+			// The headers of the outputs are informative, the rules name their output
+			if (text.rfind("- IF ", 0) == 0) {
+				rule_lines[versions.back()].push_back({line, text.substr(2)});
+			} else if (text.front() != '-' || text.back() != ':') {
+				throw error(line, "expected a rule or the name of an output");
+			}
+			break;
+		}
+	}
+
+	if (versions.empty()) {
+		throw std::invalid_argument("there are no rules defined");
+	}
+	const std::string chosen{version.empty() ? versions.back() : version};
+	if (rule_lines.count(chosen) == 0) {
+		throw std::invalid_argument("there are no rules " + chosen);
+	}
+
+	const auto find{[](std::vector<Variable>& variables, const std::string& name) -> Variable* {
+		for (Variable& v : variables) {
+			if (std::find(v.names.begin(), v.names.end(), name) != v.names.end()) {
+				return &v;
+			}
+		}
+		return nullptr;
+	}};
+
+	for (const Variable& v : inputs) {
+		for (const std::string& name : v.names) {
+			if (std::find(INPUT_NAMES.begin(), INPUT_NAMES.end(), name) == INPUT_NAMES.end()) {
+				throw std::invalid_argument("unknown input '" + name + "', the inputs are L, R, LA, RA, S and D");
+			}
+		}
+	}
+
+	// The angled distances fall back to the terms of the distances
+	std::array<Variable*, CompiledRuleBase::INPUTS> columns;
+	Definition definition;
+	for (int c{0}; c < CompiledRuleBase::INPUTS; ++c) {
+		columns[c] = find(inputs, INPUT_NAMES[c]);
+		if (columns[c] == nullptr && (INPUT_NAMES[c] == "LA" || INPUT_NAMES[c] == "RA")) {
+			columns[c] = find(inputs, INPUT_NAMES[c].substr(0, 1));
+		}
+		if (columns[c] == nullptr) {
+			throw std::invalid_argument("the input " + INPUT_NAMES[c] + " isn't declared");
+		}
+		definition.input_ranges[c] = {columns[c]->first, columns[c]->last};
+	}
+
+	if (outputs.empty()) {
+		throw std::invalid_argument("there are no outputs declared");
+	}
+	// The outputs share one universe, which spans all of their ranges
+	definition.first = outputs.front().first;
+	definition.last = outputs.front().last + 1;
+	for (const Variable& v : outputs) {
+		definition.output_names.insert(definition.output_names.end(), v.names.begin(), v.names.end());
+		definition.first = std::min(definition.first, v.first);
+		definition.last = std::max(definition.last, v.last + 1);
+	}
+	definition.rules.resize(definition.output_names.size());
+
+	IntUnaryFunction const* ignore{FunctionBuilder::constantFunction(functions).get()};
+	std::map<std::pair<int, std::vector<std::string>>, IntUnaryFunction const*> unions;
+
+	const auto termOf{[](int l, Variable* v, const std::string& name) {
+		const auto term{v->terms.find(name)};
+		if (term == v->terms.end()) {
+			throw error(l, "unknown term '" + name + "'");
+		}
+		return term->second;
+	}};
+
+	for (const RuleLine& rule_line : rule_lines[chosen]) {
+		RuleReader reader(rule_line.line, rule_line.text);
+		std::array<IntUnaryFunction const*, CompiledRuleBase::INPUTS + 1> rule;
+		rule.fill(nullptr);
+
+		reader.expect("IF");
+		do {
+			const Condition condition{reader.condition()};
+			if (rule[condition.column] != nullptr) {
+				throw error(reader.line, "the input " + INPUT_NAMES[condition.column] + " appears twice");
+			}
+
+			// Unions of the same terms are shared, so their antecedents are evaluated once
+			const auto key{std::make_pair(condition.column, condition.terms)};
+			auto iter{unions.find(key)};
+			if (iter == unions.end()) {
+				IntUnaryFunction const* f{termOf(reader.line, columns[condition.column], condition.terms[0])};
+				for (std::size_t t{1}; t < condition.terms.size(); ++t) {
+					f = functions.make<CombineZadehOrFunction>(
+						f,
+						termOf(reader.line, columns[condition.column], condition.terms[t])
+					).get();
+				}
+				iter = unions.emplace(key, f).first;
+			}
+			rule[condition.column] = iter->second;
+		} while (reader.accept("and"));
+
+		reader.expect("THEN");
+		reader.expect("(");
+		const std::string output{reader.next()};
+		reader.expect("is");
+		const std::string term{reader.next()};
+		reader.expect(")");
+		if (!reader.isFinished()) {
+			throw error(reader.line, "unexpected text after the consequent");
+		}
+
+		const auto index{std::find(definition.output_names.begin(), definition.output_names.end(), output)};
+		if (index == definition.output_names.end()) {
+			throw error(reader.line, "unknown output '" + output + "'");
+		}
+		rule[CompiledRuleBase::INPUTS] = termOf(reader.line, find(outputs, output), term);
+
+		for (int c{0}; c < CompiledRuleBase::INPUTS; ++c) {
+			if (rule[c] == nullptr) {
+				rule[c] = ignore;
+			}
+		}
+		definition.rules[index - definition.output_names.begin()].push_back(rule);
+	}
+
+	for (std::size_t o{0}; o < definition.rules.size(); ++o) {
+		if (definition.rules[o].empty()) {
+			throw std::invalid_argument("the output " + definition.output_names[o] + " has no rules " + chosen);
+		}
+	}
+
+	definition.functions = std::move(functions);
+	return definition;
+}
+
+// Identifies the text and the version a cache was made from
+static std::uint64_t cacheKey(const std::string& text, const std::string& version) {
+	std::uint64_t hash{14695981039346656037ull};
+	const auto add{[&hash](const std::string& s) {
+		for (unsigned char c : s) {
+			hash = (hash ^ c) * 1099511628211ull;
+		}
+		hash = (hash ^ 0xff) * 1099511628211ull;
+	}};
+	add(text);
+	add(version);
+	return hash;
+}
+
+static constexpr char CACHE_MAGIC[8]{'D', 'Z', '3', 'R', 'U', 'L', 'E', '1'};
+
+RuleParser::Compiled RuleParser::load(
+	const std::string& path,
+	const std::string& version,
+	const std::string& cache_path
+) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		throw std::invalid_argument("can't open the rules " + path);
+	}
+	const std::string text{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	const std::uint64_t key{cacheKey(text, version)};
+
+	std::ifstream cache(cache_path, std::ios::binary);
+	if (cache) {
+		char magic[sizeof(CACHE_MAGIC)];
+		std::uint64_t cached_key{0};
+		std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS> ranges;
+		cache.read(magic, sizeof(magic));
+		cache.read(reinterpret_cast<char*>(&cached_key), sizeof(cached_key));
+		cache.read(reinterpret_cast<char*>(ranges.data()), sizeof(ranges));
+
+		if (cache && std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) && cached_key == key) {
+			try {
+				return {CompiledRuleBase::read(cache), ranges};
+			} catch (const std::invalid_argument&) {
+				// A malformed cache is made again
+			}
+		}
+	}
+
+	std::istringstream in(text);
+	const Definition definition{parse(in, version)};
+	Compiled compiled{
+		CompiledRuleBase(definition.rules, definition.first, definition.last),
+		definition.input_ranges
+	};
+
+	// Written aside and renamed, so a reader never sees half of a cache. Failing
+	// to write the cache only costs the next start the parsing
+	const std::string temporary{cache_path + ".tmp"};
+	bool written{false};
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		out.write(reinterpret_cast<const char*>(&key), sizeof(key));
+		out.write(reinterpret_cast<const char*>(compiled.input_ranges.data()), sizeof(compiled.input_ranges));
+		try {
+			compiled.rules.write(out);
+			out.close();
+			written = static_cast<bool>(out);
+		} catch (const std::invalid_argument&) {
+		}
+	}
+
+	std::error_code ignored;
+	if (written) {
+		std::filesystem::rename(temporary, cache_path, ignored);
+	} else {
+		std::filesystem::remove(temporary, ignored);
+	}
+
+	return compiled;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "compiled_rule_base.hh"
+#include "int_unary_function.hh"
+#include "arena.hh"
+
+#include <array>
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * Loads the variables and the rules from the text format of variables.txt, e.g. rules.txt:
+ *
+ *	Input variables:
+ *		- Left/Right distance (L, R, LA, RA): [0, 1300]
+ *			- Close: \(15, 40)
+ *			- Medium: A(30, 60, 90)
+ *			- Far: /(80, 100)
+ *		- Direction (D): {0, 1}
+ *			- Right: 1
+ *	Output variables:
+ *		- Angular acceleration (W): [-400, 399]
+ *			- NB: \(-280, -240)
+ *	Rules v1:
+ *		- Angular acceleration:
+ *			- IF (L is (Medium or Close)) and ((LA is Close) or (LA is Medium)) THEN (W is NB)
+ *
+ * The inputs are L, R, LA, RA, S and D, in the order of the rule columns, and LA
+ * and RA share the terms of L and R unless they are declared. Ranges are inclusive,
+ * the outputs are inferred over the span of their ranges, a single number is the
+ * triangle around it and lines before the first section are skipped. Errors are
+ * reported with std::invalid_argument and the line number.
+ */
+namespace RuleParser {
+	struct Definition {
+		std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS> input_ranges;
+		// The outputs' universe, [first, last)
+		int first;
+		int last;
+		std::vector<std::string> output_names;
+		// The rules of every output, in the order of the output variables
+		std::vector<std::vector<std::array<IntUnaryFunction const*, CompiledRuleBase::INPUTS + 1>>> rules;
+		// Owns the terms of the rules
+		Arena functions;
+	};
+
+	// Parses the rules of the version, or of the last version if it's empty
+	Definition parse(std::istream& in, const std::string& version);
+
+	struct Compiled {
+		CompiledRuleBase rules;
+		std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS> input_ranges;
+	};
+
+	/**
+	 * Compiles the rules of the file, reusing the binary cache if it was made from
+	 * the same text and version. Otherwise the cache is written again.
+	 */
+	Compiled load(const std::string& path, const std::string& version, const std::string& cache_path);
+}
@@ -0,0 +1,96 @@
+#include "rule_table.hh"
+
+#include <limits>
+
+RuleTable::RuleTable(Arrays a): arrays{std::move(a)} {
+}
+
+int RuleTable::getNumberOfRules() const {
+	return arrays.rule_consequent.size();
+}
+
+int RuleTable::getNumberOfAntecedents() const {
+	return arrays.antecedent_input.size();
+}
+
+int RuleTable::getNumberOfConsequents() const {
+	return arrays.output_first_consequent.empty() ? 0 : arrays.output_first_consequent.back();
+}
+
+int RuleTable::getNumberOfOutputs() const {
+	return arrays.output_first_consequent.empty() ? 0 : arrays.output_first_consequent.size() - 1;
+}
+
+int RuleTable::getFirstConsequent(int output) const {
+	return arrays.output_first_consequent.at(output);
+}
+
+const RuleTable::Arrays& RuleTable::getArrays() const {
+	return arrays;
+}
+
+void RuleTable::buildActivationIndex(const std::function<Supports(int term)>& supports) {
+	activation_words = (getNumberOfRules() + 63) / 64;
+
+	for (int input{0}; input < INPUTS; ++input) {
+		std::vector<Supports> antecedent_supports(getNumberOfAntecedents());
+		std::vector<double>& bounds{activation_bounds[input]};
+		bounds.clear();
+		for (int i{0}; i < getNumberOfAntecedents(); ++i) {
+			if (arrays.antecedent_input[i] != input) {
+				continue;
+			}
+
+			antecedent_supports[i] = supports(arrays.antecedent_term[i]);
+			for (const auto& [from, to] : antecedent_supports[i]) {
+				bounds.push_back(from);
+				bounds.push_back(to);
+			}
+		}
+		std::sort(bounds.begin(), bounds.end());
+		bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+		// Every elementary interval is represented by its first point. The first one is below
+		// every support, and only reached when the lowest bound isn't an infinity
+		std::vector<std::uint64_t>& masks{activation_masks[input]};
+		masks.assign((bounds.size() + 1) * activation_words, 0);
+		for (std::size_t k{0}; k <= bounds.size(); ++k) {
+			const double x{k == 0 ? -std::numeric_limits<double>::infinity() : bounds[k - 1]};
+
+			for (int r{0}; r < getNumberOfRules(); ++r) {
+				bool active{true};
+				for (const int a : getRuleAntecedents(r)) {
+					if (arrays.antecedent_input[a] != input) {
+						continue;
+					}
+
+					const Supports& intervals{antecedent_supports[a]};
+					active = active && std::any_of(intervals.begin(), intervals.end(), [x](const auto& interval) {
+						return x >= interval.first && x < interval.second;
+					});
+				}
+
+				if (active) {
+					masks[k * activation_words + r / 64] |= std::uint64_t{1} << (r % 64);
+				}
+			}
+		}
+	}
+}
+
+const std::uint64_t* RuleTable::activeRules(const std::array<double, INPUTS>& inputs) const {
+	// The rules that can fire are the ones that no input zeroes
+	thread_local std::vector<std::uint64_t> active;
+	active.assign(activation_words, ~std::uint64_t{0});
+	for (int input{0}; input < INPUTS; ++input) {
+		const std::vector<double>& bounds{activation_bounds[input]};
+		const auto k{std::upper_bound(bounds.begin(), bounds.end(), inputs[input]) - bounds.begin()};
+
+		const std::uint64_t* mask{activation_masks[input].data() + k * activation_words};
+		for (int w{0}; w < activation_words; ++w) {
+			active[w] &= mask[w];
+		}
+	}
+
+	return active.data();
+}
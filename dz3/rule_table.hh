@@ -0,0 +1,228 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <map>
+#include <span>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <bit>
+
+/**
+ * The structure of a rule base, shared by the systems over integers and over
+ * the reals: the distinct (input, term) antecedents, the antecedents and the
+ * consequent of every rule, and the consequents of every output. The terms are
+ * kept and evaluated by the owner, the table only knows their indices. The
+ * supports of the terms are indexed per input, so that firing only goes
+ * through the rules that can have a non-zero strength.
+ */
+class RuleTable {
+public:
+	enum class Implication {
+		PRODUCT,
+		MIN
+	};
+
+	static constexpr int INPUTS{6};
+
+	// Where a term may be non-zero, as [from, to) intervals
+	using Supports = std::vector<std::pair<double, double>>;
+
+	struct Arrays {
+		// Distinct (input, term) pairs used as antecedents
+		std::vector<int> antecedent_input;
+		std::vector<int> antecedent_term;
+		// Antecedents of the rule r are rule_antecedents[rule_first[r], rule_first[r + 1])
+		std::vector<int> rule_first;
+		std::vector<int> rule_antecedents;
+		std::vector<int> rule_consequent;
+		// Consequents of the output o are [output_first_consequent[o], output_first_consequent[o + 1])
+		std::vector<int> output_first_consequent;
+	};
+
+	RuleTable() = default;
+	// A table from its arrays, e.g. read back after getArrays
+	explicit RuleTable(Arrays arrays);
+
+	/**
+	 * Adds the rules of every output. term(f) is the index of the function's term,
+	 * the terms for which isConstantOne(t) holds are left out of the antecedents,
+	 * and addConsequent(f, t) is called for every new consequent, in their order.
+	 * Consequents aren't shared between the outputs, their strengths are separate.
+	 */
+	template<typename Function, typename Term, typename IsConstantOne, typename AddConsequent>
+	void compile(
+		const std::vector<std::vector<std::array<Function const*, INPUTS + 1>>>& outputs,
+		Term term,
+		IsConstantOne isConstantOne,
+		AddConsequent addConsequent
+	);
+
+	// Indexes the rules that can fire over the elementary intervals of every input
+	void buildActivationIndex(const std::function<Supports(int term)>& supports);
+
+	/**
+	 * Writes the firing strength of every consequent, the maximum over its rules.
+	 * Returns the number of rules with a non-zero strength. value(a) evaluates the
+	 * antecedent a, at most once per call and only for the rules that can fire.
+	 * The strength of every rule is written to rule_strengths unless it's null.
+	 */
+	template<typename Value>
+	int fire(
+		const std::array<double, INPUTS>& inputs,
+		Implication implication,
+		Value value,
+		double* strengths,
+		double* rule_strengths = nullptr
+	) const;
+
+	int getNumberOfRules() const;
+	int getNumberOfAntecedents() const;
+	int getNumberOfConsequents() const;
+	int getNumberOfOutputs() const;
+	int getFirstConsequent(int output) const;
+
+	int getAntecedentInput(int antecedent) const {
+		return arrays.antecedent_input[antecedent];
+	}
+	int getAntecedentTerm(int antecedent) const {
+		return arrays.antecedent_term[antecedent];
+	}
+	std::span<const int> getRuleAntecedents(int rule) const {
+		return std::span<const int>(arrays.rule_antecedents).subspan(
+			arrays.rule_first[rule],
+			arrays.rule_first[rule + 1] - arrays.rule_first[rule]
+		);
+	}
+	int getRuleConsequent(int rule) const {
+		return arrays.rule_consequent[rule];
+	}
+
+	const Arrays& getArrays() const;
+private:
+	// The rules that no input zeroes, in a buffer of the calling thread
+	const std::uint64_t* activeRules(const std::array<double, INPUTS>& inputs) const;
+
+	Arrays arrays;
+
+	// An input within [activation_bounds[i][k - 1], activation_bounds[i][k]) zeroes every
+	// rule but the ones set in the activation_words words of its mask k, at activation_masks[i][k * activation_words]
+	std::array<std::vector<double>, INPUTS> activation_bounds;
+	std::array<std::vector<std::uint64_t>, INPUTS> activation_masks;
+	int activation_words{0};
+};
+
+template<typename Function, typename Term, typename IsConstantOne, typename AddConsequent>
+void RuleTable::compile(
+	const std::vector<std::vector<std::array<Function const*, INPUTS + 1>>>& outputs,
+	Term term,
+	IsConstantOne isConstantOne,
+	AddConsequent addConsequent
+) {
+	if (outputs.size() == 0) {
+		throw std::invalid_argument("there are no outputs provided");
+	}
+	for (const auto& rules : outputs) {
+		if (rules.size() == 0) {
+			throw std::invalid_argument("there are no rules provided");
+		}
+	}
+
+	std::map<std::pair<int, int>, int> antecedents;
+	int consequents{0};
+
+	arrays.rule_first.push_back(0);
+	for (const auto& rules : outputs) {
+		std::map<int, int> consequent_rows;
+		arrays.output_first_consequent.push_back(consequents);
+
+		for (const auto& rule : rules) {
+			for (int input{0}; input < INPUTS; ++input) {
+				const int t{term(rule[input])};
+
+				// A constant one changes neither the product nor the minimum
+				if (isConstantOne(t)) {
+					continue;
+				}
+
+				const auto key{std::make_pair(input, t)};
+				auto iter{antecedents.find(key)};
+				if (iter == antecedents.end()) {
+					iter = antecedents.emplace(key, arrays.antecedent_input.size()).first;
+					arrays.antecedent_input.push_back(input);
+					arrays.antecedent_term.push_back(t);
+				}
+				arrays.rule_antecedents.push_back(iter->second);
+			}
+			arrays.rule_first.push_back(arrays.rule_antecedents.size());
+
+			const int t{term(rule[INPUTS])};
+			auto row{consequent_rows.find(t)};
+			if (row == consequent_rows.end()) {
+				row = consequent_rows.emplace(t, consequents++).first;
+				addConsequent(rule[INPUTS], t);
+			}
+			arrays.rule_consequent.push_back(row->second);
+		}
+	}
+	arrays.output_first_consequent.push_back(consequents);
+}
+
+template<typename Value>
+int RuleTable::fire(
+	const std::array<double, INPUTS>& inputs,
+	Implication implication,
+	Value value,
+	double* strengths,
+	double* rule_strengths
+) const {
+	const std::uint64_t* active{activeRules(inputs)};
+
+	// Scratch space is reused between the calls, so the steady state doesn't allocate.
+	// Antecedents are negative until the first rule that can fire needs them
+	thread_local std::vector<double> antecedent_values;
+	antecedent_values.assign(arrays.antecedent_input.size(), -1.0);
+
+	std::fill(strengths, strengths + getNumberOfConsequents(), 0.0);
+	if (rule_strengths != nullptr) {
+		std::fill(rule_strengths, rule_strengths + getNumberOfRules(), 0.0);
+	}
+
+	// The other rules have a zero strength, which doesn't change the maximum
+	int fired{0};
+	for (int w{0}; w < activation_words; ++w) {
+		for (std::uint64_t bits{active[w]}; bits != 0; bits &= bits - 1) {
+			const int r{w * 64 + std::countr_zero(bits)};
+
+			double strength{1.0};
+			for (int i{arrays.rule_first[r]}; i < arrays.rule_first[r + 1]; ++i) {
+				const int a{arrays.rule_antecedents[i]};
+				double& val{antecedent_values[a]};
+				if (val < 0.0) {
+					val = value(a);
+				}
+
+				if (implication == Implication::PRODUCT) {
+					strength *= val;
+				} else {
+					strength = std::min(strength, val);
+				}
+			}
+
+			// Both implications are monotone, so the strongest rule dominates its consequent
+			double& s{strengths[arrays.rule_consequent[r]]};
+			s = std::max(s, strength);
+			if (strength > 0.0) {
+				++fired;
+			}
+			if (rule_strengths != nullptr) {
+				rule_strengths[r] = strength;
+			}
+		}
+	}
+
+	return fired;
+}
@@ -645,3 +645,14 @@ static std::vector<std::array<IntUnaryFunction const*, 7>> omega_v4() {
 std::vector<std::array<IntUnaryFunction const*, 7>> Rules::get_for_omega() {
 	return omega_v4();
 }
+
+std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS> Rules::get_input_ranges() {
+	return {{
+		{0, 1300},
+		{0, 1300},
+		{0, 1300},
+		{0, 1300},
+		{0, 1000},
+		{0, 1}
+	}};
+}
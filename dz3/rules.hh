@@ -1,6 +1,7 @@
 #pragma once
 
 #include "int_unary_function.hh"
+#include "compiled_rule_base.hh"
 
 #include <vector>
 #include <array>
@@ -8,4 +9,7 @@
 namespace Rules {
 	std::vector<std::array<IntUnaryFunction const*, 7>> get_for_accel();
 	std::vector<std::array<IntUnaryFunction const*, 7>> get_for_omega();
+
+	// Ranges of the inputs, in the order of the rule columns
+	std::array<CompiledRuleBase::Range, CompiledRuleBase::INPUTS> get_input_ranges();
 }
@@ -11,6 +11,14 @@ SimpleDomain::SimpleDomain(int f, int l):
 	}
 }
 
+int SimpleDomain::getFirst() const {
+	return first;
+}
+
+int SimpleDomain::getLast() const {
+	return last;
+}
+
 int SimpleDomain::getCardinality() const {
 	return last - first;
 }
@@ -7,6 +7,9 @@ class SimpleDomain : public DomainInterface {
 public:
 	SimpleDomain(int first, int last);
 
+	int                    getFirst() const;
+	int                    getLast() const;
+
 	int                    getCardinality() const override;
 	const DomainInterface* getComponent(int index) const override;
 	int                    getNumberOfComponents() const override;
@@ -0,0 +1,106 @@
+#include "sparse_fuzzy_set.hh"
+
+#include <stdexcept>
+#include <algorithm>
+
+SparseFuzzySet::SparseFuzzySet(DomainInterface* d, double threshold, std::pmr::memory_resource* resource):
+	domain{d}, threshold{threshold}, indices(resource), memberships(resource) {
+	if (domain == nullptr) {
+		throw std::invalid_argument("the domain must not be null");
+	}
+}
+
+DomainInterface* SparseFuzzySet::getDomain() {
+	return domain;
+}
+
+double SparseFuzzySet::getValueAt(const DomainElement& e) const {
+	const int index{domain->indexOfElement(e)};
+	if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
+		throw std::domain_error("the element must be inside of the set's core domain");
+	}
+
+	return getValueAtIndex(index);
+}
+
+double SparseFuzzySet::getValueAtIndex(int index) const {
+	if (index < 0 || index >= domain->getCardinality()) {
+		throw std::out_of_range("the index must be within the domain's cardinality");
+	}
+
+	const auto it{std::lower_bound(indices.begin(), indices.end(), index)};
+	if (it == indices.end() || *it != index) {
+		return 0.0;
+	}
+
+	return memberships[it - indices.begin()];
+}
+
+void SparseFuzzySet::copyMemberships(std::span<double> out) const {
+	if (out.size() != static_cast<std::size_t>(domain->getCardinality())) {
+		throw std::invalid_argument("the output must have the domain's cardinality");
+	}
+
+	std::fill(out.begin(), out.end(), 0.0);
+	for (std::size_t i{0}; i < indices.size(); ++i) {
+		out[indices[i]] = memberships[i];
+	}
+}
+
+SparseFuzzySet& SparseFuzzySet::set(const DomainElement& e, double val) {
+	const int index{domain->indexOfElement(e)};
+	if (index == DomainInterface::ELEMENT_NOT_PRESENT) {
+		throw std::domain_error("the element must be inside of the set's core domain");
+	}
+
+	return setAtIndex(index, val);
+}
+
+SparseFuzzySet& SparseFuzzySet::setAtIndex(int index, double val) {
+	if (index < 0 || index >= domain->getCardinality()) {
+		throw std::out_of_range("the index must be within the domain's cardinality");
+	}
+
+	// Sets filled in the order of the indices only ever append
+	if (indices.empty() || indices.back() < index) {
+		if (isKept(val)) {
+			indices.push_back(index);
+			memberships.push_back(val);
+		}
+		return *this;
+	}
+
+	const auto it{std::lower_bound(indices.begin(), indices.end(), index)};
+	const auto pos{it - indices.begin()};
+	const bool present{it != indices.end() && *it == index};
+
+	if (!isKept(val)) {
+		if (present) {
+			indices.erase(it);
+			memberships.erase(memberships.begin() + pos);
+		}
+	} else if (present) {
+		memberships[pos] = val;
+	} else {
+		indices.insert(it, index);
+		memberships.insert(memberships.begin() + pos, val);
+	}
+
+	return *this;
+}
+
+double SparseFuzzySet::getThreshold() const {
+	return threshold;
+}
+
+int SparseFuzzySet::getNumberOfNonZeros() const {
+	return indices.size();
+}
+
+std::span<const int> SparseFuzzySet::getIndices() const {
+	return indices;
+}
+
+std::span<const double> SparseFuzzySet::getMemberships() const {
+	return memberships;
+}
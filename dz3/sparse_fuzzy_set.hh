@@ -0,0 +1,49 @@
+#pragma once
+
+#include "fuzzy_set_interface.hh"
+#include "domain_interface.hh"
+#include "domain_element.hh"
+
+#include <vector>
+#include <memory_resource>
+#include <span>
+
+/**
+ * A fuzzy set that stores only its non-zero memberships, as (index, membership)
+ * pairs sorted by the index. The memberships below the threshold are cut off
+ * and read as zeros. Setting the memberships in the order of their indices
+ * appends them, otherwise they are inserted.
+ */
+class SparseFuzzySet : public FuzzySetInterface {
+public:
+	// The entries are allocated from the resource, e.g. Arena::getResource
+	SparseFuzzySet(
+		DomainInterface* d,
+		double threshold = 0.0,
+		std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+	);
+
+	DomainInterface* getDomain() override;
+	double           getValueAt(const DomainElement&) const override;
+	double           getValueAtIndex(int index) const override;
+	void             copyMemberships(std::span<double> out) const override;
+
+	SparseFuzzySet&  set(const DomainElement& e, double val);
+	SparseFuzzySet&  setAtIndex(int index, double val);
+
+	double getThreshold() const;
+	int    getNumberOfNonZeros() const;
+
+	// The stored entries, the indices are strictly increasing
+	std::span<const int>    getIndices() const;
+	std::span<const double> getMemberships() const;
+private:
+	bool isKept(double val) const {
+		return val != 0.0 && val >= threshold;
+	}
+
+	DomainInterface*         domain;
+	double                   threshold;
+	std::pmr::vector<int>    indices;
+	std::pmr::vector<double> memberships;
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "int_unary_function.hh"
+#include "fuzzy_unary_function.hh"
+#include "fuzzy_binary_function.hh"
+#include "trapezoid.hh"
+
+#include <array>
+#include <vector>
+#include <span>
+#include <stdexcept>
+#include <algorithm>
+#include <concepts>
+
+/**
+ * Membership functions and norms composed as types instead of linked objects,
+ * e.g. Or<Lambda<30, 60, 90>, Gamma<80, 100>>. Every type has a static valueAt,
+ * so a composition is inlined into straight-line code. Function and the norm
+ * adapters below bring a composition back into the virtual hierarchy.
+ */
+namespace Static {
+	// The Zadeh maximum and minimum, which keep the first value on ties
+	constexpr double zadehMax(double a, double b) {
+		return a >= b ? a : b;
+	}
+
+	constexpr double zadehMin(double a, double b) {
+		return a <= b ? a : b;
+	}
+
+	// Rises from 0 at A to 1 at B, the static LammaFunction(A, B, true)
+	template<int A, int B>
+	struct Gamma {
+		static_assert(A <= B, "the left point must be smaller than or equal to the right point");
+
+		static constexpr double STEP{A == B ? 0.0 : 1.0 / (B - A)};
+
+		static constexpr double valueAt(int x) {
+			const double ramp{std::max(0.0, (static_cast<double>(x) - A) * STEP)};
+			return x >= B ? 1.0 : ramp;
+		}
+
+		static constexpr std::array<Trapezoid, 1> trapezoids() {
+			return {{{A, B, Trapezoid::OPEN_RIGHT, Trapezoid::OPEN_RIGHT}}};
+		}
+	};
+
+	// Falls from 1 at A to 0 at B, the static LammaFunction(A, B, false)
+	template<int A, int B>
+	struct L {
+		static_assert(A <= B, "the left point must be smaller than or equal to the right point");
+
+		static constexpr double STEP{A == B ? 0.0 : 1.0 / (B - A)};
+
+		// Without a ramp the function is still one at its point
+		static constexpr int ZERO_FROM{A == B ? B + 1 : B};
+
+		static constexpr double valueAt(int x) {
+			const double ramp{std::min(1.0 - (static_cast<double>(x) - A) * STEP, 1.0)};
+			return x >= ZERO_FROM ? 0.0 : ramp;
+		}
+
+		static constexpr std::array<Trapezoid, 1> trapezoids() {
+			return {{{Trapezoid::OPEN_LEFT, Trapezoid::OPEN_LEFT, A, B}}};
+		}
+	};
+
+	// Rises on [LEFT, MID] and falls on [MID, RIGHT], the static LambdaFunction
+	template<int LEFT, int MID, int RIGHT>
+	struct Lambda {
+		static_assert(LEFT <= MID, "the left point must be smaller than or equal to the mid point");
+		static_assert(RIGHT >= MID, "the right point must be bigger than or equal to the mid point");
+
+		static constexpr double valueAt(int x) {
+			if constexpr (LEFT == RIGHT) {
+				return 0.0;
+			} else {
+				return Gamma<LEFT, MID>::valueAt(x) * L<MID, RIGHT>::valueAt(x);
+			}
+		}
+
+		static constexpr auto trapezoids() {
+			if constexpr (LEFT == RIGHT) {
+				return std::array<Trapezoid, 0>{};
+			} else {
+				return std::array<Trapezoid, 1>{{{LEFT, MID, MID, RIGHT}}};
+			}
+		}
+	};
+
+	struct Constant {
+		static constexpr double valueAt(int) {
+			return 1.0;
+		}
+
+		static constexpr std::array<Trapezoid, 1> trapezoids() {
+			return {{{
+				Trapezoid::OPEN_LEFT,
+				Trapezoid::OPEN_LEFT,
+				Trapezoid::OPEN_RIGHT,
+				Trapezoid::OPEN_RIGHT
+			}}};
+		}
+	};
+
+	// The Zadeh union of the functions, the static CombineZadehOrFunction
+	template<typename F, typename... Fs>
+	struct Or {
+		static constexpr double valueAt(int x) {
+			double value{F::valueAt(x)};
+			((value = zadehMax(value, Fs::valueAt(x))), ...);
+			return value;
+		}
+
+		static constexpr auto trapezoids() {
+			return concatenate(F::trapezoids(), Fs::trapezoids()...);
+		}
+	private:
+		template<std::size_t N>
+		static constexpr std::array<Trapezoid, N> concatenate(const std::array<Trapezoid, N>& a) {
+			return a;
+		}
+
+		template<std::size_t N, std::size_t M, typename... Rest>
+		static constexpr auto concatenate(
+			const std::array<Trapezoid, N>& a,
+			const std::array<Trapezoid, M>& b,
+			const Rest&... rest
+		) {
+			std::array<Trapezoid, N + M> result{};
+			std::copy(a.begin(), a.end(), result.begin());
+			std::copy(b.begin(), b.end(), result.begin() + N);
+			return concatenate(result, rest...);
+		}
+	};
+
+	// Norms, the static counterparts of the ones in fuzzy_functions.hh
+	struct ZadehNot {
+		static constexpr double valueAt(double v) {
+			return 1.0 - v;
+		}
+	};
+
+	struct ZadehAnd {
+		static constexpr double valueAt(double a, double b) {
+			return zadehMin(a, b);
+		}
+	};
+
+	struct ZadehOr {
+		static constexpr double valueAt(double a, double b) {
+			return zadehMax(a, b);
+		}
+	};
+
+	template<double P>
+	struct HamacherTNorm {
+		static_assert(P >= 0, "the parameter must be greater than 0");
+
+		static constexpr double valueAt(double a, double b) {
+			const double ab{a * b};
+
+			return ab / (P + (1.0 - P) * (a + b - ab));
+		}
+	};
+
+	template<double P>
+	struct HamacherSNorm {
+		static_assert(P >= 0, "the parameter must be greater than 0");
+
+		static constexpr double valueAt(double a, double b) {
+			const double ab{a * b};
+
+			return (a + b - (2.0 - P) * ab) / (1.0 - (1.0 - P) * ab);
+		}
+	};
+
+	// A norm applied to membership functions, e.g. Combine<HamacherTNorm<0.5>, F, G>
+	template<typename Norm, typename F, typename G>
+	struct Combine {
+		static constexpr double valueAt(int x) {
+			return Norm::valueAt(F::valueAt(x), G::valueAt(x));
+		}
+	};
+
+	template<typename Norm, typename F>
+	struct Apply {
+		static constexpr double valueAt(int x) {
+			return Norm::valueAt(F::valueAt(x));
+		}
+	};
+
+	template<typename F>
+	concept Trapezoidal = requires(int x) {
+		{ F::valueAt(x) } -> std::same_as<double>;
+		F::trapezoids();
+	};
+
+	// Adapts a composition to IntUnaryFunction, so it can be used in the rule tables
+	template<Trapezoidal F>
+	class Function : public IntUnaryFunction {
+	public:
+		double valueAt(int x) const override {
+			return F::valueAt(x);
+		}
+
+		void valuesAt(std::span<const int> in, std::span<double> out) const override {
+			if (out.size() < in.size()) {
+				throw std::invalid_argument("the output must be at least as large as the input");
+			}
+
+			for (std::size_t i{0}; i < in.size(); ++i) {
+				out[i] = F::valueAt(in[i]);
+			}
+		}
+
+		std::vector<Trapezoid> getTrapezoids() const override {
+			constexpr auto trapezoids{F::trapezoids()};
+			return {trapezoids.begin(), trapezoids.end()};
+		}
+	};
+
+	// Adapt norms to the functions taken by Operations
+	template<typename Norm>
+	class UnaryNorm : public FuzzyUnaryFunction {
+	public:
+		double valueAt(double v) const override {
+			return Norm::valueAt(v);
+		}
+	};
+
+	template<typename Norm>
+	class BinaryNorm : public FuzzyBinaryFunction {
+	public:
+		double valueAt(double a, double b) const override {
+			return Norm::valueAt(a, b);
+		}
+	};
+}
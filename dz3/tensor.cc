@@ -0,0 +1,205 @@
+#include "tensor.hh"
+
+#include "thread_pool.hh"
+
+#include <stdexcept>
+#include <algorithm>
+#include <vector>
+
+// The outputs are reduced in blocks that stay in the cache for the whole reduction
+static constexpr int BLOCK{512};
+static constexpr long long PARALLEL_THRESHOLD{1 << 22};
+
+static void checkAxes(std::span<const int> shape, std::span<const int> axes) {
+	for (const int dimension : shape) {
+		if (dimension < 0) {
+			throw std::invalid_argument("the dimensions of the shape can't be negative");
+		}
+	}
+
+	for (std::size_t k{0}; k < axes.size(); ++k) {
+		if (axes[k] < 0 || static_cast<std::size_t>(axes[k]) >= shape.size()) {
+			throw std::out_of_range("the axes must be within the shape");
+		}
+		if (k > 0 && axes[k] <= axes[k - 1]) {
+			throw std::invalid_argument("the axes must be strictly increasing");
+		}
+	}
+}
+
+static std::vector<int> stridesOf(std::span<const int> shape) {
+	std::vector<int> strides(shape.size());
+
+	int stride{1};
+	for (int a{static_cast<int>(shape.size()) - 1}; a >= 0; --a) {
+		strides[a] = stride;
+		stride *= shape[a];
+	}
+
+	return strides;
+}
+
+// The offsets of the elements spanned by the axes, in their row-major order
+static std::vector<int> offsetsOf(
+	std::span<const int> shape,
+	const std::vector<int>& strides,
+	const std::vector<int>& axes
+) {
+	std::vector<int> offsets{0};
+
+	for (const int a : axes) {
+		std::vector<int> next;
+		next.reserve(offsets.size() * shape[a]);
+
+		for (const int offset : offsets) {
+			for (int i{0}; i < shape[a]; ++i) {
+				next.push_back(offset + i * strides[a]);
+			}
+		}
+
+		offsets.swap(next);
+	}
+
+	return offsets;
+}
+
+long long Tensor::size(std::span<const int> shape) {
+	long long n{1};
+	for (const int dimension : shape) {
+		n *= dimension;
+	}
+
+	return n;
+}
+
+void Tensor::project(const double* in, std::span<const int> shape, std::span<const int> axes, double* out) {
+	checkAxes(shape, axes);
+
+	const int n{static_cast<int>(shape.size())};
+	const std::vector<int> strides{stridesOf(shape)};
+
+	const std::vector<int> kept(axes.begin(), axes.end());
+	std::vector<int> reduced;
+	for (int a{0}; a < n; ++a) {
+		if (!std::binary_search(kept.begin(), kept.end(), a)) {
+			reduced.push_back(a);
+		}
+	}
+
+	// Every output is the maximum of the inputs at its base plus each of the offsets
+	const std::vector<int> bases{offsetsOf(shape, strides, kept)};
+	const std::vector<int> offsets{offsetsOf(shape, strides, reduced)};
+	const int out_n{static_cast<int>(bases.size())};
+
+	// The supremum of nothing
+	if (offsets.empty()) {
+		std::fill(out, out + out_n, 0.0);
+		return;
+	}
+
+	// When the last axis is kept, neighbouring outputs read neighbouring inputs,
+	// otherwise the inputs of one output are the ones that are close together
+	const bool last_kept{!kept.empty() && kept.back() == n - 1};
+
+	const auto projectOutputs{[&](int first, int last) {
+		if (last_kept) {
+			for (int oo{first}; oo < last; oo += BLOCK) {
+				const int o_end{std::min(oo + BLOCK, last)};
+
+				for (int o{oo}; o < o_end; ++o) {
+					out[o] = in[bases[o] + offsets[0]];
+				}
+				for (std::size_t r{1}; r < offsets.size(); ++r) {
+					const double* in_r{in + offsets[r]};
+
+					for (int o{oo}; o < o_end; ++o) {
+						out[o] = std::max(out[o], in_r[bases[o]]);
+					}
+				}
+			}
+		} else {
+			for (int o{first}; o < last; ++o) {
+				const double* in_o{in + bases[o]};
+
+				double m{in_o[offsets[0]]};
+				for (std::size_t r{1}; r < offsets.size(); ++r) {
+					m = std::max(m, in_o[offsets[r]]);
+				}
+
+				out[o] = m;
+			}
+		}
+	}};
+
+	// Small projections aren't worth waking the workers up
+	if (size(shape) < PARALLEL_THRESHOLD) {
+		projectOutputs(0, out_n);
+	} else {
+		ThreadPool::getDefault().parallelFor(out_n, projectOutputs);
+	}
+}
+
+void Tensor::extend(const double* in, std::span<const int> shape, std::span<const int> axes, double* out) {
+	checkAxes(shape, axes);
+
+	const int n{static_cast<int>(shape.size())};
+	const long long total{size(shape)};
+	if (total == 0) {
+		return;
+	}
+	if (n == 0) {
+		out[0] = in[0];
+		return;
+	}
+
+	// The step through in along every axis of out, the other axes don't move through it
+	std::vector<int> in_strides(n, 0);
+	int stride{1};
+	for (int k{static_cast<int>(axes.size()) - 1}; k >= 0; --k) {
+		in_strides[axes[k]] = stride;
+		stride *= shape[axes[k]];
+	}
+
+	// The rows along the last axis are either copies of rows of in, or a repeated membership
+	const int columns{shape[n - 1]};
+	const int rows{static_cast<int>(total / columns)};
+	const bool last_extended{in_strides[n - 1] == 0};
+
+	const auto extendRows{[&](int first, int last) {
+		// The indices of the first row along the outer axes, and its offset in in
+		std::vector<int> indices(n - 1);
+		int offset{0};
+		for (int a{n - 2}, row{first}; a >= 0; --a) {
+			indices[a] = row % shape[a];
+			row /= shape[a];
+			offset += indices[a] * in_strides[a];
+		}
+
+		for (int r{first}; r < last; ++r) {
+			double* out_row{out + static_cast<long long>(r) * columns};
+			if (last_extended) {
+				std::fill(out_row, out_row + columns, in[offset]);
+			} else {
+				std::copy(in + offset, in + offset + columns, out_row);
+			}
+
+			// The outer axes advance like an odometer
+			for (int a{n - 2}; a >= 0; --a) {
+				offset += in_strides[a];
+				if (++indices[a] < shape[a]) {
+					break;
+				}
+
+				offset -= indices[a] * in_strides[a];
+				indices[a] = 0;
+			}
+		}
+	}};
+
+	// Small extensions aren't worth waking the workers up
+	if (total < PARALLEL_THRESHOLD) {
+		extendRows(0, rows);
+	} else {
+		ThreadPool::getDefault().parallelFor(rows, extendRows);
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <span>
+
+/**
+ * Kernels over the memberships of N-ary relations, stored as row-major tensors:
+ * the last axis changes the fastest, like the indices of a CompositeDomain.
+ * The axes are indices into the shape and must be strictly increasing.
+ */
+namespace Tensor {
+	// The number of elements of a tensor of the shape
+	long long size(std::span<const int> shape);
+
+	/**
+	 * The projection onto the axes: out, of the shape of the axes, gets the
+	 * maximum over all of the other axes. Large projections split the output
+	 * over ThreadPool::getDefault().
+	 */
+	void project(const double* in, std::span<const int> shape, std::span<const int> axes, double* out);
+
+	/**
+	 * The cylindrical extension from the axes: in has the shape of the axes,
+	 * out has the shape and repeats in along all of the other axes. Large
+	 * extensions split the output over ThreadPool::getDefault().
+	 */
+	void extend(const double* in, std::span<const int> shape, std::span<const int> axes, double* out);
+};
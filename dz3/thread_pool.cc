@@ -0,0 +1,111 @@
+#include "thread_pool.hh"
+
+#include <stdexcept>
+#include <algorithm>
+
+// Set while the thread runs a chunk of a loop, on the workers and on the calling thread
+static thread_local bool in_task{false};
+
+ThreadPool::ThreadPool(int threads) {
+	if (threads < 0) {
+		throw std::invalid_argument("the number of threads must not be negative");
+	}
+
+	for (int i{0}; i < threads; ++i) {
+		workers.emplace_back(&ThreadPool::work, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (std::thread& t : workers) {
+		t.join();
+	}
+}
+
+int ThreadPool::getNumberOfThreads() const {
+	return workers.size();
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int begin, int end)>& f) {
+	if (count <= 0) {
+		return;
+	}
+	// The pool's threads may all be waiting for this task, so a nested loop would never finish
+	if (workers.empty() || count == 1 || in_task) {
+		f(0, count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> serial(submit);
+	std::unique_lock<std::mutex> lock(mutex);
+
+	task = &f;
+	n = count;
+	chunks = std::min<int>(count, workers.size() + 1);
+	next_chunk = 0;
+	remaining = chunks;
+	error = nullptr;
+	++generation;
+	wake.notify_all();
+
+	runChunks(lock);
+	done.wait(lock, [this]() { return remaining == 0; });
+
+	task = nullptr;
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
+
+void ThreadPool::runChunks(std::unique_lock<std::mutex>& lock) {
+	while (next_chunk < chunks) {
+		const int chunk{next_chunk++};
+		const int begin{static_cast<int>(static_cast<long long>(n) * chunk / chunks)};
+		const int end{static_cast<int>(static_cast<long long>(n) * (chunk + 1) / chunks)};
+		const std::function<void(int, int)>& f{*task};
+
+		lock.unlock();
+		std::exception_ptr e;
+		in_task = true;
+		try {
+			f(begin, end);
+		} catch (...) {
+			e = std::current_exception();
+		}
+		in_task = false;
+		lock.lock();
+
+		if (e && !error) {
+			error = e;
+		}
+		if (--remaining == 0) {
+			done.notify_all();
+		}
+	}
+}
+
+void ThreadPool::work() {
+	std::uint64_t seen{0};
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true) {
+		wake.wait(lock, [&]() { return stopping || generation != seen; });
+		if (stopping) {
+			return;
+		}
+
+		seen = generation;
+		runChunks(lock);
+	}
+}
+
+ThreadPool& ThreadPool::getDefault() {
+	static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+	return pool;
+}
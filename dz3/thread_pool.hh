@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstdint>
+
+/**
+ * A fixed set of worker threads that run data-parallel loops.
+ * The calling thread works on the loop too, so a pool of n threads uses
+ * n + 1 cores. A loop started from within a task, e.g. a composition inside
+ * a parallel loop, runs on the task's thread instead of waiting for the pool.
+ */
+class ThreadPool {
+public:
+	explicit ThreadPool(int threads);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int getNumberOfThreads() const;
+
+	// Splits [0, n) into contiguous chunks, runs f(begin, end) on them and waits for all of them
+	void parallelFor(int n, const std::function<void(int begin, int end)>& f);
+
+	// A pool with one worker less than the number of hardware threads
+	static ThreadPool& getDefault();
+private:
+	void work();
+	void runChunks(std::unique_lock<std::mutex>& lock);
+
+	std::vector<std::thread> workers;
+
+	std::mutex              submit;
+	std::mutex              mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+
+	const std::function<void(int, int)>* task{nullptr};
+	int                n{0};
+	int                chunks{0};
+	int                next_chunk{0};
+	int                remaining{0};
+	std::uint64_t      generation{0};
+	bool               stopping{false};
+	std::exception_ptr error;
+};
@@ -0,0 +1,104 @@
+#include "defuzzifier_analytic_coa.hh"
+#include "multi_output_fuzzy_system.hh"
+#include "rules.hh"
+#include "fast_io.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <numbers>
+#include <random>
+#include <unistd.h>
+
+/**
+ * Writes a trace of sensor tuples in the format Simulator.jar sends, so the
+ * benchmarks run without Java. A boat drives along a winding channel whose
+ * width changes, steered by the rules themselves, so the tuples cover the
+ * states the controller actually meets. Usage: trace_gen [TICKS] [SEED].
+ */
+int main(int argc, char* argv[]) {
+	const int ticks{argc > 1 ? atoi(argv[1]) : 100000};
+	const unsigned seed(argc > 2 ? atoi(argv[2]) : 42);
+
+	constexpr double SENSOR_RANGE{1300};
+	constexpr double DT{0.1};
+	// Radians of heading per unit of omega and tick
+	constexpr double TURN{0.0005};
+	constexpr double PI{std::numbers::pi};
+
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> curvatures(-0.004, 0.004);
+	std::uniform_real_distribution<double> widths(120, 400);
+	std::uniform_int_distribution<int> lengths(200, 800);
+	std::normal_distribution<double> noise(0.0, 0.01);
+
+	const MultiOutputFuzzySystem controller(
+		new DefuzzifierAnalyticCOA(),
+		{Rules::get_for_accel(), Rules::get_for_omega()},
+		CompiledRuleBase::Implication::PRODUCT,
+		Rules::get_input_ranges()
+	);
+
+	// The heading is relative to the channel's axis, the left bank is at y = width / 2
+	double y{0};
+	double heading{0};
+	double speed{20};
+	double width{widths(generator)};
+	double target_width{width};
+	double curvature{0};
+	int segment{0};
+
+	// The distance to a bank along the direction at the angle phi to the axis
+	const auto sensor{[&](double phi) {
+		const double s{std::sin(phi)};
+		double distance{SENSOR_RANGE};
+		if (s > 1e-9) {
+			distance = (width / 2 - y) / s;
+		} else if (s < -1e-9) {
+			distance = (-width / 2 - y) / s;
+		}
+		return static_cast<int>(std::lround(std::clamp(distance, 0.0, SENSOR_RANGE)));
+	}};
+
+	FastWriter output(STDOUT_FILENO);
+	std::array<int, 2> outputs;
+	for (int tick{0}; tick < ticks; ++tick) {
+		if (segment-- == 0) {
+			segment = lengths(generator);
+			curvature = curvatures(generator);
+			target_width = widths(generator);
+		}
+		width += (target_width - width) * 0.01;
+
+		const std::array<int, CompiledRuleBase::INPUTS> in{
+			sensor(heading + PI / 2),
+			sensor(heading - PI / 2),
+			sensor(heading + PI / 4),
+			sensor(heading - PI / 4),
+			static_cast<int>(std::lround(speed)),
+			std::cos(heading) > 0 ? 1 : 0
+		};
+		for (std::size_t i{0}; i < in.size(); ++i) {
+			output.writeInt(in[i]);
+			output.writeChar(i + 1 < in.size() ? ' ' : '\n');
+		}
+
+		controller.infer(in[0], in[1], in[2], in[3], in[4], in[5], outputs);
+
+		speed = std::clamp(speed + outputs[0] * DT, 0.0, 120.0);
+		// The channel bends under the boat, which turns the heading relative to the axis
+		heading += outputs[1] * TURN - curvature * speed * DT + noise(generator);
+		heading = std::remainder(heading, 2 * PI);
+		y += speed * DT * std::sin(heading);
+
+		// A bank reflects the boat and slows it down
+		if (std::abs(y) > width / 2) {
+			y = std::copysign(width / 2, y);
+			heading = -heading;
+			speed /= 2;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <limits>
+#include <cmath>
+
+/**
+ * A trapezoidal membership function described by its four breakpoints.
+ * The function rises on [a, b], equals 1 on [b, c] and falls on [c, d].
+ * A missing shoulder is expressed with the OPEN_LEFT/OPEN_RIGHT sentinels.
+ */
+struct Trapezoid {
+	static constexpr int OPEN_LEFT{std::numeric_limits<int>::min()};
+	static constexpr int OPEN_RIGHT{std::numeric_limits<int>::max()};
+
+	int a;
+	int b;
+	int c;
+	int d;
+
+	double rise(int x) const {
+		if (x >= b) {
+			return 1.0;
+		}
+		if (x <= a) {
+			return 0.0;
+		}
+
+		return (x - a) * (1.0 / (b - a));
+	}
+
+	double fall(int x) const {
+		if (x <= c) {
+			return 1.0;
+		}
+		if (x >= d) {
+			return 0.0;
+		}
+
+		return 1.0 - (x - c) * (1.0 / (d - c));
+	}
+
+	double valueAt(int x) const {
+		return rise(x) * fall(x);
+	}
+
+	bool isConstantOne() const {
+		return b == OPEN_LEFT && c == OPEN_RIGHT;
+	}
+};
+
+/**
+ * A trapezoid over the reals, with infinite breakpoints for a missing shoulder.
+ * The integer trapezoids extend to it, so that their terms can be evaluated
+ * between the integers.
+ */
+struct RealTrapezoid {
+	static constexpr double OPEN_LEFT{-std::numeric_limits<double>::infinity()};
+	static constexpr double OPEN_RIGHT{std::numeric_limits<double>::infinity()};
+
+	double a;
+	double b;
+	double c;
+	double d;
+
+	static RealTrapezoid fromTrapezoid(const Trapezoid& t) {
+		return {
+			t.a == Trapezoid::OPEN_LEFT ? OPEN_LEFT : t.a,
+			t.b == Trapezoid::OPEN_LEFT ? OPEN_LEFT : t.b,
+			t.c == Trapezoid::OPEN_RIGHT ? OPEN_RIGHT : t.c,
+			t.d == Trapezoid::OPEN_RIGHT ? OPEN_RIGHT : t.d
+		};
+	}
+
+	double rise(double x) const {
+		if (x >= b) {
+			return 1.0;
+		}
+		if (x <= a) {
+			return 0.0;
+		}
+
+		return (x - a) / (b - a);
+	}
+
+	double fall(double x) const {
+		if (x <= c) {
+			return 1.0;
+		}
+		if (x >= d) {
+			return 0.0;
+		}
+
+		return 1.0 - (x - c) / (d - c);
+	}
+
+	double valueAt(double x) const {
+		return rise(x) * fall(x);
+	}
+};